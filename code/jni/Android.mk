@@ -133,7 +133,7 @@ LOCAL_STATIC_LIBRARIES := _magemath _magecore png
 
 include $(BUILD_STATIC_LIBRARY)
 
-#android wars
+#android wars simulation (game rules only, no app, renderer, UI or online client)
 include $(CLEAR_VARS)
 
 aw_game_path := game
@@ -142,15 +142,8 @@ aw_mainmenu_path := mainmenu
 aw_data_path := data
 aw_states_path := states
 
-LOCAL_MODULE    := androidwars
-LOCAL_SRC_FILES := androidwars.cpp \
-$(aw_states_path)/InputState.cpp \
-$(aw_states_path)/DialogInputState.cpp \
-$(aw_states_path)/ProgressInputState.cpp \
-$(aw_states_path)/GameState.cpp \
-$(aw_states_path)/GameStateManager.cpp \
-$(aw_mainmenu_path)/MainMenuState.cpp \
-$(aw_data_path)/TerrainType.cpp \
+LOCAL_MODULE    := androidwars_sim
+LOCAL_SRC_FILES := $(aw_data_path)/TerrainType.cpp \
 $(aw_data_path)/TerrainTypesTable.cpp \
 $(aw_data_path)/UnitType.cpp \
 $(aw_data_path)/Weapon.cpp \
@@ -158,13 +151,44 @@ $(aw_data_path)/UnitTypesTable.cpp \
 $(aw_data_path)/MovementType.cpp \
 $(aw_data_path)/MovementTypesTable.cpp \
 $(aw_data_path)/Scenario.cpp \
-$(aw_game_path)/GameplayState.cpp \
-$(aw_game_path)/GameplayInputStates.cpp \
 $(aw_game_path)/Game.cpp \
 $(aw_game_path)/Player.cpp \
 $(aw_game_path)/Faction.cpp \
 $(aw_game_path)/Unit.cpp \
 $(aw_game_path)/Map.cpp \
+$(aw_game_path)/ThreatMap.cpp \
+$(aw_game_path)/PathHierarchy.cpp \
+$(aw_game_path)/AIPlanner.cpp \
+$(aw_game_path)/GameSnapshot.cpp \
+$(aw_game_path)/RolloutEngine.cpp \
+ util/Log.cpp \
+ util/PrimaryDirection.cpp \
+ util/WorkerGroup.cpp
+
+LOCAL_STATIC_LIBRARIES := _magemath _magecore
+LOCAL_C_INCLUDES := $(LOCAL_PATH) $(LOCAL_PATH)/libs/rapidjson
+LOCAL_EXPORT_C_INCLUDES := $(LOCAL_PATH) $(LOCAL_PATH)/libs/rapidjson
+LOCAL_CFLAGS += -std=c++11
+ifeq ($(APP_OPTIM),debug)
+LOCAL_CFLAGS += -D_DEBUG
+endif
+
+include $(BUILD_STATIC_LIBRARY)
+
+#android wars
+include $(CLEAR_VARS)
+
+LOCAL_MODULE    := androidwars
+LOCAL_SRC_FILES := androidwars.cpp \
+$(aw_states_path)/InputState.cpp \
+$(aw_states_path)/DialogInputState.cpp \
+$(aw_states_path)/ProgressInputState.cpp \
+$(aw_states_path)/GameState.cpp \
+$(aw_states_path)/GameStateManager.cpp \
+$(aw_mainmenu_path)/MainMenuState.cpp \
+$(aw_data_path)/ScenarioAnimations.cpp \
+$(aw_game_path)/GameplayState.cpp \
+$(aw_game_path)/GameplayInputStates.cpp \
 $(aw_game_path)/MapView.cpp \
 $(aw_game_path)/TileSprite.cpp \
 $(aw_game_path)/UnitSprite.cpp \
@@ -181,11 +205,10 @@ $(aw_editor_path)/EditorInputStates.cpp \
  ui/ListLayout.cpp \
  sound/SoundManager.cpp \
  online/OnlineGameClient.cpp \
- util/JNI.cpp \
- util/PrimaryDirection.cpp
+ util/JNI.cpp
 
 LOCAL_LDLIBS := -llog -landroid -lEGL -lGLESv2 -lOpenSLES
-LOCAL_STATIC_LIBRARIES := android_native_app_glue _magemath _magecore _magerenderer png _mageapp
+LOCAL_STATIC_LIBRARIES := androidwars_sim android_native_app_glue _magemath _magecore _magerenderer png _mageapp
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/libs/rapidjson
 LOCAL_CFLAGS += -std=c++11
 
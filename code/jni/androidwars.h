@@ -25,20 +25,13 @@ extern mage::OnlineGameClient* gOnlineGameClient;
 extern mage::int32 gWindowWidth;
 extern mage::int32 gWindowHeight;
 
-const size_t MAP_SIZE_POWER_OF_TWO = 10;
-
 #include <MageApp.h>
+#include <new>
 
 #include "util/JNI.h"
-#include "util/Delegate.h"
-#include "util/PrimaryDirection.h"
-#include "util/Grid.h"
-#include "util/MinHeap.h"
 
-#include "rapidjson/rapidjson.h"
-#include "rapidjson/document.h"
-#include "rapidjson/prettywriter.h"
-#include "rapidjson/stringbuffer.h"
+// Game rules (shared with the androidwars_sim library).
+#include "androidwars_sim.h"
 
 #include "states/InputState.h"
 #include "states/DialogInputState.h"
@@ -61,26 +54,10 @@ const size_t MAP_SIZE_POWER_OF_TWO = 10;
 
 #include "mainmenu/MainMenuState.h"
 
-#include "data/Table.h"
-#include "data/TerrainTypesTable.h"
-#include "data/TerrainType.h"
-#include "data/MovementTypesTable.h"
-#include "data/MovementType.h"
-#include "data/UnitTypesTable.h"
-#include "data/UnitType.h"
-#include "data/Weapon.h"
-#include "data/Scenario.h"
-
-#include "game/Path.h"
-#include "game/Map.h"
-#include "game/Faction.h"
 #include "game/TileSprite.h"
 #include "game/UnitSprite.h"
 #include "game/ArrowSprite.h"
 #include "game/MapView.h"
-#include "game/Player.h"
-#include "game/Unit.h"
-#include "game/Game.h"
 #include "game/GameplayState.h"
 #include "game/GameplayInputStates.h"
 
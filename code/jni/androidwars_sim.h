@@ -0,0 +1,63 @@
+#pragma once
+
+/**
+ * Includes everything needed to run the game rules (data, Map, Unit, Faction and Game) without the app, renderer,
+ * UI or online client. Code that only simulates games (tools, servers, tests) can include this instead of
+ * androidwars.h and link against the androidwars_sim library.
+ */
+
+namespace mage
+{
+	class Game;
+	class Map;
+	class Unit;
+	class Faction;
+	class Player;
+}
+
+#include <MageTypes.h>
+#include <MageMath.h>
+#include <MageCore.h>
+#include <new>
+
+const size_t MAP_SIZE_POWER_OF_TWO = 10;
+
+#include "util/Delegate.h"
+#include "util/PrimaryDirection.h"
+#include "util/Grid.h"
+#include "util/MinHeap.h"
+#include "util/IndexedMinHeap.h"
+#include "util/Log.h"
+#include "util/RandomStream.h"
+#include "util/WorkerGroup.h"
+
+#include "rapidjson/rapidjson.h"
+#include "rapidjson/document.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#include "util/JSON.h"
+
+#include "data/Table.h"
+#include "data/TerrainTypesTable.h"
+#include "data/TerrainType.h"
+#include "data/MovementTypesTable.h"
+#include "data/MovementType.h"
+#include "data/UnitTypesTable.h"
+#include "data/UnitType.h"
+#include "data/Weapon.h"
+#include "data/Scenario.h"
+
+#include "game/Path.h"
+#include "game/TileIndexSet.h"
+#include "game/SearchContext.h"
+#include "game/PathHierarchy.h"
+#include "game/Map.h"
+#include "game/Faction.h"
+#include "game/Player.h"
+#include "game/Unit.h"
+#include "game/ThreatMap.h"
+#include "game/AIPlanner.h"
+#include "game/Game.h"
+#include "game/GameSnapshot.h"
+#include "game/RolloutEngine.h"
@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * Minimal helpers shared by the host benchmarks. Each benchmark is a small program that prints its measurements and
+ * returns a non-zero exit code when the implementations it compares disagree about the result.
+ * Timings are only meaningful in an optimized build (configure with -DCMAKE_BUILD_TYPE=Release).
+ */
+
+#include "tests/TestUtil.h"
+#include <time.h>
+
+namespace BenchmarkUtil
+{
+	inline double GetMonotonicTimeSeconds()
+	{
+		timespec time;
+		clock_gettime( CLOCK_MONOTONIC, &time );
+		return ( time.tv_sec + time.tv_nsec * 1e-9 );
+	}
+
+
+	/**
+	 * Calls the function the given number of times and returns the average time per call in milliseconds.
+	 */
+	template< typename Function >
+	inline double MeasureMilliseconds( int runCount, const Function& function )
+	{
+		double startTime = GetMonotonicTimeSeconds();
+
+		for( int i = 0; i < runCount; ++i )
+		{
+			function();
+		}
+
+		return ( ( GetMonotonicTimeSeconds() - startTime ) * 1000.0 / std::max( runCount, 1 ) );
+	}
+}
@@ -0,0 +1,98 @@
+#include "BenchmarkUtil.h"
+
+using namespace mage;
+
+namespace
+{
+	const short MAP_SIZE = 256;
+	const int RUN_COUNT = 50;
+
+	typedef Grid< int, 8 > IntGrid;
+	typedef Delegate< void, const IntGrid::ConstIterator& > TileDelegate;
+}
+
+
+int main()
+{
+	IntGrid grid;
+	grid.Resize( MAP_SIZE, MAP_SIZE );
+
+	int value = 0;
+
+	grid.ForEachTile( [&value]( const IntGrid::Iterator& tile )
+	{
+		*tile = ( value++ % 7 );
+	});
+
+	const IntGrid& constGrid = grid;
+	int64 delegateTotal = 0;
+	int64 templateTotal = 0;
+	int64 lookupTotal = 0;
+
+	// Call a Delegate for each tile (one virtual call per tile, as the visitor APIs did before they were templated).
+	double delegateTime = BenchmarkUtil::MeasureMilliseconds( RUN_COUNT, [&]()
+	{
+		int64 total = 0;
+		TileDelegate delegate( [&total]( const IntGrid::ConstIterator& tile ) { total += *tile; } );
+
+		constGrid.ForEachTile( [&delegate]( const IntGrid::ConstIterator& tile )
+		{
+			delegate.Invoke( tile );
+		});
+
+		delegateTotal = total;
+	});
+
+	// Pass the lambda straight to the templated visitor (inlined into the loop over each chunk row).
+	double templateTime = BenchmarkUtil::MeasureMilliseconds( RUN_COUNT, [&]()
+	{
+		int64 total = 0;
+
+		constGrid.ForEachTile( [&total]( const IntGrid::ConstIterator& tile )
+		{
+			total += *tile;
+		});
+
+		templateTotal = total;
+	});
+
+	// Look up every tile by position (finding its chunk each time).
+	double lookupTime = BenchmarkUtil::MeasureMilliseconds( RUN_COUNT, [&]()
+	{
+		int64 total = 0;
+
+		for( short y = 0; y < MAP_SIZE; ++y )
+		{
+			for( short x = 0; x < MAP_SIZE; ++x )
+			{
+				total += *constGrid.GetTile( x, y );
+			}
+		}
+
+		lookupTotal = total;
+	});
+
+	// Every loop must visit the same tiles.
+	CHECK( delegateTotal == templateTotal );
+	CHECK( lookupTotal == templateTotal );
+
+	// Areas that start and end partway through a chunk must visit the same tiles as well.
+	RectS area( 5, 3, 200, 77 );
+	int64 areaTotal = 0;
+	int64 areaLookupTotal = 0;
+
+	constGrid.ForEachTileInArea( area, [&]( const IntGrid::ConstIterator& tile )
+	{
+		areaTotal += *tile;
+		areaLookupTotal += *constGrid.GetTile( tile.GetPosition() );
+	});
+
+	CHECK( areaTotal == areaLookupTotal );
+
+	std::printf( "%dx%d grid, average of %d passes:\n", MAP_SIZE, MAP_SIZE, RUN_COUNT );
+	std::printf( "%-10s %10.3f ms\n", "delegate", delegateTime );
+	std::printf( "%-10s %10.3f ms\n", "template", templateTime );
+	std::printf( "%-10s %10.3f ms\n", "GetTile", lookupTime );
+
+	return TestUtil::GetExitCode();
+}
@@ -0,0 +1,183 @@
+#include "BenchmarkUtil.h"
+
+using namespace mage;
+
+namespace
+{
+	const short MAP_SIZES[] = { 64, 128, 256 };
+	const short MAX_MAP_SIZE = 256;
+	const int RUN_COUNT = 3;
+	const int MAX_TERRAIN_COST = 3;
+
+	typedef FixedSizeMinHeap< MAX_MAP_SIZE * MAX_MAP_SIZE, int, int > FixedSizeOpenList;
+	typedef IndexedMinHeap< int > IndexedOpenList;
+
+
+	/**
+	 * Per-tile costs and search state for a square map of open terrain.
+	 */
+	struct SearchMap
+	{
+		short size;
+		std::vector< int > costs;
+		std::vector< int > bestCosts;
+		std::vector< bool > closed;
+		int updateCount;
+	};
+
+
+	void BeginSearch( SearchMap& searchMap, int originIndex )
+	{
+		searchMap.bestCosts.assign( searchMap.costs.size(), INT_MAX );
+		searchMap.closed.assign( searchMap.costs.size(), false );
+		searchMap.bestCosts[ originIndex ] = 0;
+		searchMap.updateCount = 0;
+	}
+
+
+	/**
+	 * Runs Dijkstra's algorithm from the center of the map and returns the sum of the cost to reach every tile.
+	 * OpenListAdapter hides the differences between the two heap interfaces.
+	 */
+	template< typename OpenListAdapter >
+	int64 Search( SearchMap& searchMap, OpenListAdapter& openList )
+	{
+		short size = searchMap.size;
+		int originIndex = ( ( size / 2 ) * size + ( size / 2 ) );
+		BeginSearch( searchMap, originIndex );
+		openList.Insert( 0, originIndex );
+
+		int64 totalCost = 0;
+
+		while( !openList.IsEmpty() )
+		{
+			int cost;
+			int tileIndex = openList.PopMin( cost );
+			searchMap.closed[ tileIndex ] = true;
+			totalCost += cost;
+
+			short tileX = (short) ( tileIndex % size );
+			short tileY = (short) ( tileIndex / size );
+
+			for( size_t i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
+			{
+				Vec2s offset = CARDINAL_DIRECTIONS[ i ].GetOffset();
+				short adjacentX = ( tileX + offset.x );
+				short adjacentY = ( tileY + offset.y );
+
+				if( adjacentX < 0 || adjacentY < 0 || adjacentX >= size || adjacentY >= size )
+				{
+					continue;
+				}
+
+				// Moving between two tiles costs the terrain cost of both, so a tile can be reached again more cheaply.
+				int adjacentIndex = ( adjacentY * size + adjacentX );
+				int costToEnter = ( cost + searchMap.costs[ tileIndex ] + searchMap.costs[ adjacentIndex ] );
+
+				if( searchMap.closed[ adjacentIndex ] || costToEnter >= searchMap.bestCosts[ adjacentIndex ] )
+				{
+					continue;
+				}
+
+				if( searchMap.bestCosts[ adjacentIndex ] != INT_MAX )
+				{
+					// If the tile is already open, decrease its key.
+					openList.Update( costToEnter, adjacentIndex );
+					++searchMap.updateCount;
+				}
+				else
+				{
+					openList.Insert( costToEnter, adjacentIndex );
+				}
+
+				searchMap.bestCosts[ adjacentIndex ] = costToEnter;
+			}
+		}
+
+		return totalCost;
+	}
+
+
+	struct FixedSizeOpenListAdapter
+	{
+		FixedSizeOpenList* heap;
+
+		void Insert( int key, int tileIndex ) { heap->insert( key, tileIndex ); }
+		void Update( int key, int tileIndex ) { heap->update( key, tileIndex ); }
+		bool IsEmpty() const { return heap->isEmpty(); }
+
+		int PopMin( int& key )
+		{
+			FixedSizeOpenList::Pair node = heap->popMinNode();
+			key = node.key;
+			return node.value;
+		}
+	};
+
+
+	struct IndexedOpenListAdapter
+	{
+		IndexedOpenList* heap;
+
+		void Insert( int key, int tileIndex ) { heap->insert( key, (size_t) tileIndex ); }
+		void Update( int key, int tileIndex ) { heap->update( key, (size_t) tileIndex ); }
+		bool IsEmpty() const { return heap->isEmpty(); }
+
+		int PopMin( int& key )
+		{
+			IndexedOpenList::Pair node = heap->popMinNode();
+			key = node.key;
+			return (int) node.index;
+		}
+	};
+}
+
+
+int main()
+{
+	// The fixed-size heap stores its nodes inline, so keep it off the stack.
+	FixedSizeOpenList* fixedSizeHeap = new FixedSizeOpenList();
+	IndexedOpenList indexedHeap;
+	RandomStream random( 1 );
+
+	std::printf( "%-8s %12s %12s %10s %10s\n", "map", "fixed (ms)", "indexed (ms)", "speedup", "updates" );
+
+	for( size_t i = 0; i < sizeof( MAP_SIZES ) / sizeof( MAP_SIZES[ 0 ] ); ++i )
+	{
+		// Vary the terrain cost so that the search has to update the keys of open tiles.
+		SearchMap searchMap;
+		searchMap.size = MAP_SIZES[ i ];
+		searchMap.costs.resize( (size_t) searchMap.size * searchMap.size );
+
+		for( auto it = searchMap.costs.begin(); it != searchMap.costs.end(); ++it )
+		{
+			*it = random.RandomInRange( 1, MAX_TERRAIN_COST );
+		}
+
+		indexedHeap.resize( searchMap.costs.size() );
+
+		FixedSizeOpenListAdapter fixedSizeOpenList = { fixedSizeHeap };
+		IndexedOpenListAdapter indexedOpenList = { &indexedHeap };
+		int64 fixedSizeTotalCost = 0;
+		int64 indexedTotalCost = 0;
+
+		double fixedSizeTime = BenchmarkUtil::MeasureMilliseconds( RUN_COUNT, [&]()
+		{
+			fixedSizeTotalCost = Search( searchMap, fixedSizeOpenList );
+		});
+
+		double indexedTime = BenchmarkUtil::MeasureMilliseconds( RUN_COUNT, [&]()
+		{
+			indexedTotalCost = Search( searchMap, indexedOpenList );
+		});
+
+		// Both heaps must find the same shortest paths.
+		CHECK( fixedSizeTotalCost == indexedTotalCost );
+
+		std::printf( "%3dx%-4d %12.2f %12.2f %9.1fx %10d\n", searchMap.size, searchMap.size, fixedSizeTime, indexedTime,
+					 fixedSizeTime / std::max( indexedTime, 1e-6 ), searchMap.updateCount );
+	}
+
+	delete fixedSizeHeap;
+	return TestUtil::GetExitCode();
+}
@@ -0,0 +1,120 @@
+#include "BenchmarkUtil.h"
+
+using namespace mage;
+
+namespace
+{
+	const short MAP_WIDTH = 32;
+	const short MAP_HEIGHT = 24;
+	const short ROAD_SPACING = 6;
+	const int CITY_PERCENTAGE = 8;
+	const int SEA_PERCENTAGE = 10;
+	const uint64 MAP_SEED = 3;
+
+	const char* const UNIT_TYPE_NAMES[] = { "Infantry", "MediumTank", "Tank" };
+	const Vec2s UNIT_POSITIONS[] = { Vec2s( 3, 3 ), Vec2s( 16, 12 ), Vec2s( 27, 20 ) };
+
+
+	/**
+	 * Fills the Map with plains crossed by a grid of roads, with scattered cities and patches of sea.
+	 */
+	void CreateTerrain( Scenario& scenario, Map& map )
+	{
+		TerrainType* roadType = scenario.TerrainTypes.FindByName( "Road" );
+		TerrainType* cityType = scenario.TerrainTypes.FindByName( "City" );
+		TerrainType* seaType = scenario.TerrainTypes.FindByName( "Sea" );
+		RandomStream random( MAP_SEED );
+
+		for( short y = 0; y < MAP_HEIGHT; ++y )
+		{
+			for( short x = 0; x < MAP_WIDTH; ++x )
+			{
+				if( x % ROAD_SPACING == 0 || y % ROAD_SPACING == 0 )
+				{
+					TestUtil::SetTerrain( map, x, y, roadType );
+					continue;
+				}
+
+				int roll = random.RandomInRange( 0, 99 );
+
+				if( roll < SEA_PERCENTAGE )
+				{
+					TestUtil::SetTerrain( map, x, y, seaType );
+				}
+				else if( roll < SEA_PERCENTAGE + CITY_PERCENTAGE )
+				{
+					TestUtil::SetTerrain( map, x, y, cityType );
+				}
+			}
+		}
+
+		map.FlushChangedTiles();
+	}
+}
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	Map map;
+	map.Init( &scenario );
+	map.Resize( MAP_WIDTH, MAP_HEIGHT );
+	map.FillWithDefaultTerrainType();
+	CreateTerrain( scenario, map );
+
+	Faction* faction = map.CreateFaction();
+	SearchContext reachableContext;
+	SearchContext pathContext;
+	Path path;
+
+	std::printf( "%dx%d map: tiles expanded by FindBestPathToTile to each reachable tile, versus a full search of the movement range\n", MAP_WIDTH, MAP_HEIGHT );
+	std::printf( "%-12s %8s %8s %12s %12s %14s\n", "unit", "origin", "queries", "expanded", "full range", "us per query" );
+
+	for( size_t i = 0; i < sizeof( UNIT_TYPE_NAMES ) / sizeof( UNIT_TYPE_NAMES[ 0 ] ); ++i )
+	{
+		for( size_t j = 0; j < sizeof( UNIT_POSITIONS ) / sizeof( UNIT_POSITIONS[ 0 ] ); ++j )
+		{
+			// Put the Unit on a road so it can always move.
+			Vec2s origin( UNIT_POSITIONS[ j ].x - UNIT_POSITIONS[ j ].x % ROAD_SPACING, UNIT_POSITIONS[ j ].y );
+			Unit* unit = map.CreateUnit( scenario.UnitTypes.FindByName( UNIT_TYPE_NAMES[ i ] ), faction, origin.x, origin.y );
+
+			// Find every tile the Unit can reach (the search a pointer-motion query would do without a heuristic).
+			map.FindReachableTiles( unit, reachableContext );
+			const TileIndexSet& reachableTiles = reachableContext.GetReachedTiles();
+			int fullRangeExpandedCount = reachableContext.GetExpandedTileCount();
+
+			int queryCount = 0;
+			int64 expandedCount = 0;
+
+			double queryTime = BenchmarkUtil::MeasureMilliseconds( 1, [&]()
+			{
+				for( auto it = reachableTiles.begin(); it != reachableTiles.end(); ++it )
+				{
+					// Every reachable tile (other than the origin) must have a path.
+					Vec2s destination = map.GetTilePosFromCompactIndex( *it );
+
+					if( destination != origin )
+					{
+						CHECK( map.FindBestPathToTile( unit, destination, path, pathContext ) );
+						expandedCount += pathContext.GetExpandedTileCount();
+						++queryCount;
+					}
+				}
+			});
+
+			std::printf( "%-12s (%2d,%2d) %8d %12.1f %12d %14.2f\n", UNIT_TYPE_NAMES[ i ], origin.x, origin.y, queryCount,
+						 (double) expandedCount / std::max( queryCount, 1 ), fullRangeExpandedCount, queryTime * 1000.0 / std::max( queryCount, 1 ) );
+
+			// Remove the Unit so it does not block the next origin (Map::DestroyUnit does not free its tile).
+			unit->Die();
+		}
+	}
+
+	return TestUtil::GetExitCode();
+}
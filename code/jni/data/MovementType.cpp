@@ -1,4 +1,4 @@
-#include "androidwars.h"
+#include "androidwars_sim.h"
 
 using namespace mage;
 
@@ -38,12 +38,19 @@ bool MovementType::CanMoveAcrossTerrain( TerrainType* terrainType ) const
 
 
 int MovementType::GetMovementCostAcrossTerrain( TerrainType* terrainType ) const
+{
+	// Look up the cost in the Scenario's flattened movement cost table.
+	return GetScenario()->GetMovementCost( this, terrainType );
+}
+
+
+int MovementType::FindMovementCostByTerrainTypeName( const HashString& terrainTypeName ) const
 {
 	// By default, don't allow movement across this type of terrain.
 	int result = -1;
 
 	// Get the hash value for this TerrainType (if it exists).
-	auto it = mMovementCostsByTerrainTypeID.find( terrainType->GetName() );
+	auto it = mMovementCostsByTerrainTypeID.find( terrainTypeName );
 
 	if( it != mMovementCostsByTerrainTypeID.end() )
 	{
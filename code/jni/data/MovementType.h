@@ -21,6 +21,7 @@ namespace mage
 
 	protected:
 		void AddMovementCost( const HashString& movementTypeName, int movementCost );
+		int FindMovementCostByTerrainTypeName( const HashString& terrainTypeName ) const;
 
 		bool mRequiresSuppliesToSurvive;
 		int mSuppliesConsumedPerTurn;
@@ -28,5 +29,6 @@ namespace mage
 		HashMap< int > mMovementCostsByTerrainTypeID;
 
 		friend class MovementTypesTable;
+		friend class Scenario;
 	};
 }
@@ -1,4 +1,4 @@
-#include "androidwars.h"
+#include "androidwars_sim.h"
 
 using namespace mage;
 
@@ -18,6 +18,10 @@ MovementTypesTable::~MovementTypesTable() { }
 
 void MovementTypesTable::OnLoadRecordFromXml( MovementType* movementType, XmlReader::XmlReaderIterator xmlIterator )
 {
+	// Read in how this movement type uses supplies.
+	movementType->mSuppliesConsumedPerTurn = xmlIterator.GetAttributeAsInt( "suppliesConsumedPerTurn", 0 );
+	movementType->mRequiresSuppliesToSurvive = xmlIterator.GetAttributeAsBool( "requiresSuppliesToSurvive", false );
+
 	// Read in the movement cost info for this movement type.
 	static const char* movementCostName = "MovementCost";
 
@@ -35,6 +39,10 @@ void MovementTypesTable::OnLoadRecordFromXml( MovementType* movementType, XmlRea
 
 void MovementTypesTable::OnLoadRecordFromJSON( MovementType* movementType, const rapidjson::Value& object )
 {
+	// Read in how this movement type uses supplies.
+	movementType->mSuppliesConsumedPerTurn = GetJSONIntValue( object, "suppliesConsumedPerTurn", 0 );
+	movementType->mRequiresSuppliesToSurvive = GetJSONBoolValue( object, "requiresSuppliesToSurvive", false );
+
 	if( object.HasMember( MOVEMENT_COSTS_JSON_PROPERTY_NAME ) )
 	{
 		const rapidjson::Value& movementCostsArray = object[ MOVEMENT_COSTS_JSON_PROPERTY_NAME ];
@@ -73,3 +81,14 @@ void MovementTypesTable::OnLoadRecordFromJSON( MovementType* movementType, const
 		}
 	}
 }
+
+
+void MovementTypesTable::OnLinkRecord( MovementType* movementType )
+{
+	for( auto it = movementType->mMovementCostsByTerrainTypeID.begin(); it != movementType->mMovementCostsByTerrainTypeID.end(); ++it )
+	{
+		// Make sure every movement cost refers to an existing TerrainType.
+		assertion( GetScenario()->TerrainTypes.FindByName( it->first ), "TerrainType \"%s\" referenced by movement costs for %s does not exist!",
+				   it->first.GetCString(), movementType->ToString() );
+	}
+}
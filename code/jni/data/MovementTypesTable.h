@@ -18,5 +18,6 @@ namespace mage
 	protected:
 		virtual void OnLoadRecordFromXml( MovementType* movementType, XmlReader::XmlReaderIterator xmlIterator );
 		virtual void OnLoadRecordFromJSON( MovementType* movementType, const rapidjson::Value& object );
+		virtual void OnLinkRecord( MovementType* movementType );
 	};
 }
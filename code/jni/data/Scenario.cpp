@@ -1,4 +1,4 @@
-#include "androidwars.h"
+#include "androidwars_sim.h"
 
 #include "CoreLib.h"
 
@@ -30,6 +30,10 @@ Scenario::Scenario()
 	: TerrainTypes( this )
 	, UnitTypes( this )
 	, MovementTypes( this )
+	, mDefaultTerrainType( nullptr )
+	, mMovementCostTableStride( 0 )
+	, mDamageTableWeaponStride( 0 )
+	, mDamageTableUnitTypeCount( 0 )
 { }
 
 
@@ -134,6 +138,9 @@ void Scenario::LoadDataFromXML( XmlReader::XmlReaderIterator rootIterator )
 	TerrainTypes.LoadRecordsFromXML( rootIterator );
 	UnitTypes.LoadRecordsFromXML( rootIterator );
 	MovementTypes.LoadRecordsFromXML( rootIterator );
+
+	// Resolve references between records.
+	LinkData();
 }
 
 
@@ -150,16 +157,50 @@ void Scenario::LoadDataFromJSON( const rapidjson::Value& object )
 	UnitTypes.LoadRecordsFromJSON( object );
 	MovementTypes.LoadRecordsFromJSON( object );
 
+	// Resolve references between records.
+	LinkData();
+
 	//DebugPrintData();
 }
 
 
+void Scenario::LinkData()
+{
+	// Resolve all references by name to direct references.
+	TerrainTypes.LinkRecords();
+	UnitTypes.LinkRecords();
+	MovementTypes.LinkRecords();
+
+	// Look up the default TerrainType.
+	mDefaultTerrainType = TerrainTypes.FindByName( mDefaultTerrainTypeName );
+	assertion( mDefaultTerrainType || mDefaultTerrainTypeName.GetString().empty(), "Default TerrainType \"%s\" for Scenario \"%s\" does not exist!",
+			   mDefaultTerrainTypeName.GetCString(), mName.GetCString() );
+
+	// Flatten the movement costs and weapon damage for fast lookup.
+	BuildMovementCostTable();
+	BuildDamageTable();
+}
+
+
 void Scenario::ClearData()
 {
 	// Clear all game data.
 	TerrainTypes.DeleteAllRecords();
 	UnitTypes.DeleteAllRecords();
 	MovementTypes.DeleteAllRecords();
+
+	// Clear all references to deleted records.
+	mDefaultTerrainType = nullptr;
+
+	// Clear the movement cost table.
+	mMovementCostTable.clear();
+	mMinimumMovementCosts.clear();
+	mMovementCostTableStride = 0;
+
+	// Clear the damage table.
+	mDamageTable.clear();
+	mDamageTableWeaponStride = 0;
+	mDamageTableUnitTypeCount = 0;
 }
 
 
@@ -197,19 +238,22 @@ void Scenario::SetDefaultTerrainType( TerrainType* defaultTerrainType )
 
 TerrainType* Scenario::GetDefaultTerrainType()
 {
-	return TerrainTypes.FindByName( mDefaultTerrainTypeName );
+	return mDefaultTerrainType;
 }
 
 
 const TerrainType* Scenario::GetDefaultTerrainType() const
 {
-	return TerrainTypes.FindByName( mDefaultTerrainTypeName );
+	return mDefaultTerrainType;
 }
 
 
 void Scenario::SetDefaultTerrainTypeName( const HashString& defaultTerrainTypeName )
 {
 	mDefaultTerrainTypeName = defaultTerrainTypeName;
+
+	// Look up the TerrainType (if it has already been loaded).
+	mDefaultTerrainType = TerrainTypes.FindByName( mDefaultTerrainTypeName );
 }
 
 
@@ -217,3 +261,73 @@ HashString Scenario::GetDefaultTerrainTypeName() const
 {
 	return mDefaultTerrainTypeName;
 }
+
+
+void Scenario::BuildMovementCostTable()
+{
+	int movementTypeCount = MovementTypes.GetRecordCount();
+	int terrainTypeCount = TerrainTypes.GetRecordCount();
+
+	// By default, don't allow movement across any type of terrain.
+	mMovementCostTableStride = terrainTypeCount;
+	mMovementCostTable.assign( movementTypeCount * terrainTypeCount, -1 );
+	mMinimumMovementCosts.assign( movementTypeCount, 0 );
+
+	for( int movementTypeID = 0; movementTypeID < movementTypeCount; ++movementTypeID )
+	{
+		const MovementType* movementType = MovementTypes.FindByID( movementTypeID );
+		int* row = &mMovementCostTable[ movementTypeID * terrainTypeCount ];
+		int minimumCost = -1;
+
+		for( int terrainTypeID = 0; terrainTypeID < terrainTypeCount; ++terrainTypeID )
+		{
+			// Store the cost of moving across each TerrainType.
+			int cost = movementType->FindMovementCostByTerrainTypeName( TerrainTypes.FindByID( terrainTypeID )->GetName() );
+			row[ terrainTypeID ] = cost;
+
+			if( cost > -1 && ( minimumCost < 0 || cost < minimumCost ) )
+			{
+				// Keep track of the cheapest passable TerrainType.
+				minimumCost = cost;
+			}
+		}
+
+		// Store the cheapest cost of moving one tile (used to scale pathfinding heuristics).
+		mMinimumMovementCosts[ movementTypeID ] = std::max( minimumCost, 0 );
+	}
+}
+
+
+void Scenario::BuildDamageTable()
+{
+	int unitTypeCount = UnitTypes.GetRecordCount();
+	int weaponStride = 0;
+
+	for( int unitTypeID = 0; unitTypeID < unitTypeCount; ++unitTypeID )
+	{
+		// Find the largest number of weapons any UnitType has.
+		weaponStride = std::max( weaponStride, UnitTypes.FindByID( unitTypeID )->GetNumWeapons() );
+	}
+
+	// By default, no weapon can target any UnitType.
+	mDamageTableWeaponStride = weaponStride;
+	mDamageTableUnitTypeCount = unitTypeCount;
+	mDamageTable.assign( unitTypeCount * weaponStride * unitTypeCount, 0 );
+
+	for( int attackerTypeID = 0; attackerTypeID < unitTypeCount; ++attackerTypeID )
+	{
+		const UnitType* attackerType = UnitTypes.FindByID( attackerTypeID );
+
+		for( int weaponIndex = 0; weaponIndex < attackerType->GetNumWeapons(); ++weaponIndex )
+		{
+			const Weapon& weapon = attackerType->GetWeaponByIndex( weaponIndex );
+			int* row = &mDamageTable[ ( attackerTypeID * weaponStride + weaponIndex ) * unitTypeCount ];
+
+			for( int defenderTypeID = 0; defenderTypeID < unitTypeCount; ++defenderTypeID )
+			{
+				// Store the damage the weapon does against each UnitType.
+				row[ defenderTypeID ] = weapon.GetDamagePercentageAgainstUnitType( UnitTypes.FindByID( defenderTypeID ) );
+			}
+		}
+	}
+}
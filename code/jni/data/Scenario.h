@@ -23,7 +23,9 @@ namespace mage
 		void LoadDataFromString( const char* data );
 		void LoadDataFromXML( XmlReader::XmlReaderIterator rootIterator );
 		void LoadDataFromJSON( const rapidjson::Value& object );
+		void LinkData();
 		void ClearData();
+		void LoadAnimations();
 
 		void DebugPrintData() const;
 
@@ -36,6 +38,15 @@ namespace mage
 		void SetDefaultTerrainTypeName( const HashString& defaultTerrainTypeName );
 		HashString GetDefaultTerrainTypeName() const;
 
+		void BuildMovementCostTable();
+		const int* GetMovementCostsByTerrainTypeID( const MovementType* movementType ) const;
+		int GetMovementCost( const MovementType* movementType, const TerrainType* terrainType ) const;
+		int GetMinimumMovementCost( const MovementType* movementType ) const;
+
+		void BuildDamageTable();
+		const int* GetDamagePercentagesByUnitTypeID( const UnitType* attackerType, int weaponIndex ) const;
+		int GetDamagePercentage( const UnitType* attackerType, int weaponIndex, const UnitType* defenderType ) const;
+
 		TerrainTypesTable TerrainTypes;
 		UnitTypesTable UnitTypes;
 		MovementTypesTable MovementTypes;
@@ -43,5 +54,53 @@ namespace mage
 	protected:
 		HashString mName;
 		HashString mDefaultTerrainTypeName;
+		TerrainType* mDefaultTerrainType;
+		int mMovementCostTableStride;
+		std::vector< int > mMovementCostTable;
+		std::vector< int > mMinimumMovementCosts;
+		int mDamageTableWeaponStride;
+		int mDamageTableUnitTypeCount;
+		std::vector< int > mDamageTable;
 	};
+
+
+	inline const int* Scenario::GetMovementCostsByTerrainTypeID( const MovementType* movementType ) const
+	{
+		assertion( movementType->GetID() >= 0 && movementType->GetID() < MovementTypes.GetRecordCount(), "Cannot get movement costs for %s because it has no valid ID!", movementType->ToString() );
+		assertion( !mMovementCostTable.empty(), "Cannot get movement costs for %s because the movement cost table has not been built!", movementType->ToString() );
+
+		// Return the row of costs for this MovementType, indexed by TerrainType ID.
+		return &mMovementCostTable[ movementType->GetID() * mMovementCostTableStride ];
+	}
+
+
+	inline int Scenario::GetMovementCost( const MovementType* movementType, const TerrainType* terrainType ) const
+	{
+		assertion( terrainType->GetID() >= 0 && terrainType->GetID() < mMovementCostTableStride, "Cannot get movement cost over %s because it has no valid ID!", terrainType->ToString() );
+		return GetMovementCostsByTerrainTypeID( movementType )[ terrainType->GetID() ];
+	}
+
+
+	inline int Scenario::GetMinimumMovementCost( const MovementType* movementType ) const
+	{
+		assertion( movementType->GetID() >= 0 && movementType->GetID() < (int) mMinimumMovementCosts.size(), "Cannot get minimum movement cost for %s because it has no valid ID!", movementType->ToString() );
+		return mMinimumMovementCosts[ movementType->GetID() ];
+	}
+
+
+	inline const int* Scenario::GetDamagePercentagesByUnitTypeID( const UnitType* attackerType, int weaponIndex ) const
+	{
+		assertion( attackerType->GetID() >= 0 && attackerType->GetID() < mDamageTableUnitTypeCount, "Cannot get damage percentages for %s because it has no valid ID!", attackerType->ToString() );
+		assertion( weaponIndex >= 0 && weaponIndex < attackerType->GetNumWeapons(), "Cannot get damage percentages for weapon %d of %s because the weapon does not exist!", weaponIndex, attackerType->ToString() );
+
+		// Return the row of damage percentages for this weapon, indexed by the defending UnitType's ID.
+		return &mDamageTable[ ( attackerType->GetID() * mDamageTableWeaponStride + weaponIndex ) * mDamageTableUnitTypeCount ];
+	}
+
+
+	inline int Scenario::GetDamagePercentage( const UnitType* attackerType, int weaponIndex, const UnitType* defenderType ) const
+	{
+		assertion( defenderType->GetID() >= 0 && defenderType->GetID() < mDamageTableUnitTypeCount, "Cannot get damage percentage against %s because it has no valid ID!", defenderType->ToString() );
+		return GetDamagePercentagesByUnitTypeID( attackerType, weaponIndex )[ defenderType->GetID() ];
+	}
 }
@@ -0,0 +1,36 @@
+#include "androidwars.h"
+
+using namespace mage;
+
+
+// Loading animations requires the renderer, so these are part of the app rather than the androidwars_sim library.
+
+
+void TerrainType::LoadAnimation()
+{
+	// Load the animation.
+	SpriteManager::LoadSpriteAnimations( mAnimationSetPath.c_str() );
+}
+
+
+void UnitType::LoadAnimation()
+{
+	// Load the animation.
+	SpriteManager::LoadSpriteAnimations( mAnimationSetPath.c_str() );
+}
+
+
+void Scenario::LoadAnimations()
+{
+	for( int i = 0; i < TerrainTypes.GetRecordCount(); ++i )
+	{
+		// Pre-load the animation set for each TerrainType.
+		TerrainTypes.FindByID( i )->LoadAnimation();
+	}
+
+	for( int i = 0; i < UnitTypes.GetRecordCount(); ++i )
+	{
+		// Pre-load the animation set for each UnitType.
+		UnitTypes.FindByID( i )->LoadAnimation();
+	}
+}
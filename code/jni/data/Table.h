@@ -28,6 +28,9 @@ namespace mage
 		static const char* const RECORD_NAME;
 
 		typedef HashMap< RecordType* > RecordsByHashedName;
+		typedef std::vector< RecordType* > RecordsByID;
+
+		static const int INVALID_ID = -1;
 
 		/**
 		 * Abstract base class for basic Record type that can be indexed by a unique name.
@@ -42,13 +45,15 @@ namespace mage
 
 			Scenario* GetScenario() const;
 			TableType* GetTable() const;
-			HashString GetName() const;
+			int GetID() const;
+			const HashString& GetName() const;
 			const char* ToString() const;
 
 		protected:
 			TableType* mTable;
 			const std::string mDebugName;
 			const HashString mName;
+			int mID;
 
 		private:
 			static std::string GenerateDebugName( const HashString& name );
@@ -64,11 +69,15 @@ namespace mage
 		void LoadRecordsFromJSON( const rapidjson::Value& object );
 		RecordType* CreateRecord( const HashString& name );
 		void AddRecord( RecordType* record );
+		void LinkRecords();
 		void DeleteAllRecords();
 		const RecordsByHashedName& GetRecords() const;
+		int GetRecordCount() const;
 
 		RecordType* FindByName( const HashString& name );
 		const RecordType* FindByName( const HashString& name ) const;
+		RecordType* FindByID( int id );
+		const RecordType* FindByID( int id ) const;
 
 		void DebugPrintData() const;
 
@@ -79,12 +88,18 @@ namespace mage
 
 		virtual void OnLoadRecordFromXml( RecordType* record, XmlReader::XmlReaderIterator elementIterator ) = 0;
 		virtual void OnLoadRecordFromJSON( RecordType* record, const rapidjson::Value& object ) = 0;
+		virtual void OnLinkRecord( RecordType* record );
 
 		Scenario* mScenario;
 		RecordsByHashedName mRecords;
+		RecordsByID mRecordsByID;
 	};
 
 
+	MAGE_TABLE_TEMPLATE
+	const int MAGE_TABLE::INVALID_ID;
+
+
 	MAGE_TABLE_TEMPLATE
 	MAGE_TABLE::Table( Scenario* scenario ) :
 		mScenario( scenario )
@@ -208,14 +223,33 @@ namespace mage
 		record->mTable = (TableType*)( this );
 
 		// Make sure a record with the same unique name doesn't already exist in this Table.
-		HashString name = record->GetName();
+		const HashString& name = record->GetName();
 		assertion( FindByName( name ) == nullptr, "Cannot create record because the name \"%s\" is not unique!", name.GetString().c_str() );
 
 		// Index the record by its name.
 		mRecords[ name ] = record;
+
+		// Assign the record a dense ID so it can be used to index flat lookup tables.
+		record->mID = (int) mRecordsByID.size();
+		mRecordsByID.push_back( record );
+	}
+
+
+	MAGE_TABLE_TEMPLATE
+	void MAGE_TABLE::LinkRecords()
+	{
+		for( auto it = mRecordsByID.begin(); it != mRecordsByID.end(); ++it )
+		{
+			// Resolve the references from each record to records in other tables.
+			OnLinkRecord( *it );
+		}
 	}
 
 
+	MAGE_TABLE_TEMPLATE
+	void MAGE_TABLE::OnLinkRecord( RecordType* record ) { }
+
+
 	MAGE_TABLE_TEMPLATE
 	void MAGE_TABLE::DeleteAllRecords()
 	{
@@ -229,6 +263,7 @@ namespace mage
 
 		// Clear the list of records.
 		mRecords.clear();
+		mRecordsByID.clear();
 	}
 
 
@@ -239,6 +274,13 @@ namespace mage
 	}
 
 
+	MAGE_TABLE_TEMPLATE
+	int MAGE_TABLE::GetRecordCount() const
+	{
+		return (int) mRecordsByID.size();
+	}
+
+
 	MAGE_TABLE_TEMPLATE
 	RecordType* MAGE_TABLE::FindByName( const HashString& name )
 	{
@@ -277,6 +319,22 @@ namespace mage
 	}
 
 
+	MAGE_TABLE_TEMPLATE
+	RecordType* MAGE_TABLE::FindByID( int id )
+	{
+		assertion( id >= 0 && id < GetRecordCount(), "Cannot find %s with ID %d because it is out of range!", RECORD_NAME, id );
+		return mRecordsByID[ id ];
+	}
+
+
+	MAGE_TABLE_TEMPLATE
+	const RecordType* MAGE_TABLE::FindByID( int id ) const
+	{
+		assertion( id >= 0 && id < GetRecordCount(), "Cannot find %s with ID %d because it is out of range!", RECORD_NAME, id );
+		return mRecordsByID[ id ];
+	}
+
+
 	MAGE_TABLE_TEMPLATE
 	void MAGE_TABLE::DebugPrintData() const
 	{
@@ -302,6 +360,7 @@ namespace mage
 		: mName( name )
 		, mTable( nullptr )
 		, mDebugName( GenerateDebugName( name ) )
+		, mID( INVALID_ID )
 	{ }
 
 
@@ -337,7 +396,14 @@ namespace mage
 
 
 	MAGE_TABLE_TEMPLATE
-	HashString MAGE_TABLE::Record::GetName() const
+	int MAGE_TABLE::Record::GetID() const
+	{
+		return mID;
+	}
+
+
+	MAGE_TABLE_TEMPLATE
+	const HashString& MAGE_TABLE::Record::GetName() const
 	{
 		return mName;
 	}
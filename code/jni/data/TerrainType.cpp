@@ -1,4 +1,4 @@
-#include "androidwars.h"
+#include "androidwars_sim.h"
 
 using namespace mage;
 
@@ -300,13 +300,6 @@ void TerrainType::DestroyAllVariations()
 }
 
 
-void TerrainType::LoadAnimation()
-{
-	// Load the animation.
-	SpriteManager::LoadSpriteAnimations( mAnimationSetPath.c_str() );
-}
-
-
 HashString TerrainType::GetAnimationSetName() const
 {
 	return mAnimationSetName;
@@ -77,9 +77,9 @@ namespace mage
 		int GetCoverBonus() const;
 		bool IsCapturable() const;
 
-	protected:
 		void LoadAnimation();
 
+	protected:
 		Variations mVariations;
 		HashString mAnimationSetName;
 		std::string mAnimationSetPath;
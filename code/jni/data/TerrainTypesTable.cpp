@@ -1,4 +1,4 @@
-#include "androidwars.h"
+#include "androidwars_sim.h"
 
 using namespace mage;
 
@@ -29,6 +29,7 @@ void TerrainTypesTable::OnLoadRecordFromJSON( TerrainType* terrainType, const ra
 	terrainType->mAnimationSetPath = Scenario::FormatAnimationPath( GetJSONStringValue( object, "animationSet", "" ) );
 	terrainType->mIsCapturable = GetJSONBoolValue( object, "isCapturable", false );
 	terrainType->mCoverBonus = GetJSONIntValue( object, "coverBonus", 0 );
+	terrainType->mIncome = GetJSONIntValue( object, "income", 0 );
 
 	if( object.HasMember( "variations" ) )
 	{
@@ -48,9 +49,6 @@ void TerrainTypesTable::OnLoadRecordFromJSON( TerrainType* terrainType, const ra
 			WarnFail( "Cannot load variations for %s from JSON because the \"variations\" property is not an array!", terrainType->ToString() );
 		}
 	}
-
-	// Pre-load the animation set.
-	terrainType->LoadAnimation();
 }
 
 
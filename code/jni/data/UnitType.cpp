@@ -1,4 +1,4 @@
-#include "androidwars.h"
+#include "androidwars_sim.h"
 
 using namespace mage;
 
@@ -7,21 +7,15 @@ const int UnitType::DEFAULT_MAX_SUPPLIES;
 
 UnitType::UnitType( const HashString& name )
 	: Record( name )
+	, mMovementType( nullptr )
 { }
 
 
 UnitType::~UnitType() { }
 
 
-void UnitType::LoadAnimation()
-{
-	// Load the animation.
-	SpriteManager::LoadSpriteAnimations( mAnimationSetPath.c_str() );
-}
-
-
 MovementType* UnitType::GetMovementType() const
 {
-	// Look up the MovementType from the Scenario.
-	return GetScenario()->MovementTypes.FindByName( mMovementTypeName );
+	assertion( mMovementType, "MovementType \"%s\" for %s has not been linked!", mMovementTypeName.GetCString(), ToString() );
+	return mMovementType;
 }
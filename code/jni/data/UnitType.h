@@ -30,14 +30,15 @@ namespace mage
 		bool CanMoveAcrossTerrain( TerrainType* terrainType ) const;
 		HashString GetAnimationSetName() const;
 
-	protected:
 		void LoadAnimation();
 
+	protected:
 		int mMovementRange;
 		int mMaxAmmo;
 		int mMaxSupplies;
 		IntRange mAttackRange;
 		HashString mMovementTypeName;
+		MovementType* mMovementType;
 		HashString mAnimationSetName;		// Name of the animation set, Tank.anim
 		std::string mAnimationSetPath;		// Path to the animation set, sprites/Tank.anim
 		std::string mDisplayName;
@@ -1,4 +1,4 @@
-#include "androidwars.h"
+#include "androidwars_sim.h"
 
 using namespace mage;
 
@@ -19,10 +19,9 @@ UnitTypesTable::~UnitTypesTable() { }
 
 void UnitTypesTable::OnLoadRecordFromXml( UnitType* unitType, XmlReader::XmlReaderIterator xmlIterator )
 {
-	// Read in the sprite for this UnitType and pre-load it.
+	// Read in the sprite for this UnitType.
 	unitType->mAnimationSetPath = Scenario::FormatAnimationPath( xmlIterator.GetAttributeAsString( "animationSet" ) );
 	unitType->mAnimationSetName = Scenario::FormatAnimationName( xmlIterator.GetAttributeAsString( "animationSet" ) );
-	unitType->LoadAnimation();
 
 	// Read in the unit display name (if it exists).
 	unitType->mDisplayName = xmlIterator.GetAttributeAsString( "displayName", "" );
@@ -57,10 +56,9 @@ void UnitTypesTable::OnLoadRecordFromXml( UnitType* unitType, XmlReader::XmlRead
 
 void UnitTypesTable::OnLoadRecordFromJSON( UnitType* unitType, const rapidjson::Value& object )
 {
-	// Read in the sprite for this UnitType and pre-load it.
+	// Read in the sprite for this UnitType.
 	unitType->mAnimationSetPath = Scenario::FormatAnimationPath( GetJSONStringValue( object, "animationSet", "" ) );
 	unitType->mAnimationSetName = Scenario::FormatAnimationName( GetJSONStringValue( object, "animationSet", "" ) );
-	unitType->LoadAnimation();
 
 	// Read in the unit display name (if it exists).
 	unitType->mDisplayName = GetJSONStringValue( object, "displayName", "" );
@@ -114,6 +112,31 @@ void UnitTypesTable::OnLoadRecordFromJSON( UnitType* unitType, const rapidjson::
 }
 
 
+void UnitTypesTable::OnLinkRecord( UnitType* unitType )
+{
+	// Resolve the MovementType.
+	unitType->mMovementType = GetScenario()->MovementTypes.FindByName( unitType->mMovementTypeName );
+	assertion( unitType->mMovementType, "MovementType \"%s\" for %s does not exist!", unitType->mMovementTypeName.GetCString(), unitType->ToString() );
+
+	for( auto it = unitType->mWeapons.begin(); it != unitType->mWeapons.end(); ++it )
+	{
+		// Resolve the UnitTypes targeted by each Weapon.
+		LinkWeapon( unitType, *it );
+	}
+}
+
+
+void UnitTypesTable::LinkWeapon( UnitType* unitType, Weapon& weapon )
+{
+	for( auto it = weapon.mDamagePercentagesByUnitTypeName.begin(); it != weapon.mDamagePercentagesByUnitTypeName.end(); ++it )
+	{
+		// Make sure each targeted UnitType exists (the Scenario's damage table looks the damage values up by ID).
+		UnitType* target = FindByName( it->first );
+		assertion( target, "UnitType \"%s\" targeted by Weapon \"%s\" of %s does not exist!", it->first.GetCString(), weapon.GetName().GetCString(), unitType->ToString() );
+	}
+}
+
+
 void UnitTypesTable::LoadWeaponFromXml( Weapon& weapon, XmlReader::XmlReaderIterator xmlIterator )
 {
 	// Load properties.
@@ -20,6 +20,8 @@ namespace mage
 	protected:
 		virtual void OnLoadRecordFromXml( UnitType* unitType, XmlReader::XmlReaderIterator xmlIterator );
 		virtual void OnLoadRecordFromJSON( UnitType* unitType, const rapidjson::Value& object );
+		virtual void OnLinkRecord( UnitType* unitType );
+		void LinkWeapon( UnitType* unitType, Weapon& weapon );
 		void LoadWeaponFromXml( Weapon& weapon, XmlReader::XmlReaderIterator xmlIterator );
 		void LoadWeaponFromJSON( Weapon& weapon, const rapidjson::Value& object );
 	};
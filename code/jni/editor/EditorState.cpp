@@ -90,6 +90,9 @@ void EditorState::OnEnter( const Dictionary& parameters )
 	bool success = mScenario.LoadDataFromFile( "data/Data.json" );
 	assertion( success, "The Scenario file \"%s\" could not be opened!" );
 
+	// Pre-load all animations used by the Scenario.
+	mScenario.LoadAnimations();
+
 	// Create a new Map and paint it with default tiles.
 	mMap.Init( &mScenario );
 	mMap.Resize( 16, 12 );
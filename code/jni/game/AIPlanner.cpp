@@ -0,0 +1,391 @@
+#include "androidwars_sim.h"
+
+#include <time.h>
+
+using namespace mage;
+
+
+namespace
+{
+	// Weights used to score the tiles a Unit can move to.
+	const float COVER_WEIGHT = 0.5f;
+	const float THREAT_WEIGHT = 1.0f;
+	const float APPROACH_WEIGHT = 0.25f;
+	const float DAMAGE_WEIGHT = 1.0f;
+	const float KILL_BONUS = 5.0f;
+
+
+	double GetMonotonicTimeSeconds()
+	{
+		timespec time;
+		clock_gettime( CLOCK_MONOTONIC, &time );
+		return ( time.tv_sec + time.tv_nsec * 1e-9 );
+	}
+}
+
+
+const int AIPlanner::MAX_CANDIDATES_PER_UNIT;
+const int AIPlanner::MAX_WORKER_COUNT;
+const float AIPlanner::DEFAULT_TIME_BUDGET_SECONDS = 0.2f;
+
+
+AIPlanner::AIPlanner() :
+	mMap( nullptr ),
+	mFaction( nullptr ),
+	mTimeBudget( DEFAULT_TIME_BUDGET_SECONDS ),
+	mWorkerCount( 1 ),
+	mDeadline( 0.0 ),
+	mNextUnitPlanIndex( 0 ),
+	mRanOutOfTime( false )
+{
+	SetWorkerCount( WorkerGroup::GetDefaultWorkerCount( MAX_WORKER_COUNT ) );
+}
+
+
+AIPlanner::~AIPlanner()
+{
+	for( auto it = mSearchContexts.begin(); it != mSearchContexts.end(); ++it )
+	{
+		delete *it;
+	}
+}
+
+
+void AIPlanner::SetTimeBudget( float timeBudgetSeconds )
+{
+	mTimeBudget = std::max( timeBudgetSeconds, 0.0f );
+}
+
+
+void AIPlanner::SetWorkerCount( int workerCount )
+{
+	mWorkerCount = Mathi::Clamp( workerCount, 1, MAX_WORKER_COUNT );
+}
+
+
+void AIPlanner::PlanTurn( Map* map, Faction* faction )
+{
+	assertion( map, "Cannot plan turn for null Map!" );
+	assertion( faction, "Cannot plan turn for null Faction!" );
+
+	mMap = map;
+	mFaction = faction;
+	mOrders.clear();
+	mTargets.clear();
+	mUnitPlans.clear();
+	mRanOutOfTime = false;
+
+	// Stop evaluating Units once the time budget has been spent.
+	mDeadline = ( GetMonotonicTimeSeconds() + mTimeBudget );
+
+	// Find the tiles enemy Units will be able to attack next turn.
+	mThreatMap.Build( mMap, mFaction );
+
+	const Map::Units& units = mMap->GetUnits();
+
+	for( auto it = units.begin(); it != units.end(); ++it )
+	{
+		Unit* unit = *it;
+
+		if( !unit->IsAlive() )
+		{
+			continue;
+		}
+
+		if( unit->GetOwner() == mFaction )
+		{
+			// Plan an action for every Unit in the Faction.
+			UnitPlan plan;
+			plan.unit = unit;
+			plan.candidateCount = 0;
+			mUnitPlans.push_back( plan );
+		}
+		else
+		{
+			// Every other Unit is a potential target. Its defense doesn't depend on the attacker, so only calculate it once.
+			Target target;
+			target.unit = unit;
+			target.defenseBonus = unit->GetDefenseBonus();
+			mTargets.push_back( target );
+		}
+	}
+
+	// Don't start more workers than there are Units to evaluate.
+	int workerCount = std::max( std::min( mWorkerCount, (int) mUnitPlans.size() ), 1 );
+
+	while( (int) mSearchContexts.size() < workerCount )
+	{
+		// Each worker needs its own search context.
+		mSearchContexts.push_back( new SearchContext() );
+	}
+
+	mNextUnitPlanIndex = 0;
+
+	// Evaluate the Units on all workers (each with its own search context).
+	WorkerGroup::Run( workerCount, [this]( int workerIndex )
+	{
+		RunWorker( *mSearchContexts[ workerIndex ] );
+	});
+
+	if( mRanOutOfTime )
+	{
+		LogInfo( "AI ran out of time after evaluating %d of %d Units.", std::min( (int) mNextUnitPlanIndex, (int) mUnitPlans.size() ), (int) mUnitPlans.size() );
+	}
+
+	// Choose one action for each Unit.
+	AssignOrders();
+}
+
+
+void AIPlanner::ExecuteTurn( Game* game )
+{
+	assertion( game, "Cannot execute AI turn for null Game!" );
+
+	for( auto it = mOrders.begin(); it != mOrders.end(); ++it )
+	{
+		Unit* unit = it->unit;
+
+		if( !unit->IsAlive() )
+		{
+			continue;
+		}
+
+		Map::Iterator destination = game->GetMap()->GetTile( it->path.GetDestination() );
+
+		if( it->path.GetLength() > 0 && !destination->IsEmpty() )
+		{
+			// If another Unit ended up on the chosen tile after planning, stay put (the attack is still made if in range).
+			LogWarning( "%s cannot move to (%d,%d) because the tile is occupied.", unit->ToString().c_str(), destination.GetX(), destination.GetY() );
+		}
+		else
+		{
+			// Move the Unit to its chosen tile.
+			unit->Move( it->path );
+		}
+
+		if( it->target && it->target->IsAlive() && unit->CanAttack( *it->target ) )
+		{
+			// If the Unit chose to attack (and the target is still there), attack it.
+			unit->Attack( *it->target, game->GetRandom() );
+		}
+	}
+
+	mOrders.clear();
+}
+
+
+void AIPlanner::RunWorker( SearchContext& context )
+{
+	while( true )
+	{
+		if( GetMonotonicTimeSeconds() > mDeadline )
+		{
+			// If the time budget has been spent, stop evaluating Units.
+			mRanOutOfTime = true;
+			break;
+		}
+
+		// Claim the next Unit to evaluate.
+		int index = __sync_fetch_and_add( &mNextUnitPlanIndex, 1 );
+
+		if( index >= (int) mUnitPlans.size() )
+		{
+			break;
+		}
+
+		EvaluateUnit( mUnitPlans[ index ], context );
+	}
+}
+
+
+void AIPlanner::EvaluateUnit( UnitPlan& plan, SearchContext& context ) const
+{
+	const Unit* unit = plan.unit;
+	const UnitType* unitType = unit->GetUnitType();
+	const IntRange& attackRange = unitType->GetAttackRange();
+	const Scenario* scenario = mMap->GetScenario();
+
+	// Find the damage the Unit can do to each target (which doesn't depend on where the Unit attacks from).
+	std::vector< int > damagePercentages( mTargets.size(), 0 );
+
+	for( size_t i = 0; i < mTargets.size(); ++i )
+	{
+		const UnitType* targetType = mTargets[ i ].unit->GetUnitType();
+		int weaponIndex = Unit::ChooseBestWeaponAgainst( scenario, unitType, unit->GetAmmo(), targetType );
+
+		if( weaponIndex > -1 )
+		{
+			// Use the most damaging weapon that can currently fire at the target.
+			int baseDamagePercentage = scenario->GetDamagePercentage( unitType, weaponIndex, targetType );
+			damagePercentages[ i ] = Unit::ScaleDamagePercentage( baseDamagePercentage, unit->GetHealth(), mTargets[ i ].defenseBonus );
+		}
+	}
+
+	// Find all tiles the Unit can move to.
+	mMap->FindReachableTiles( unit, context );
+	const TileIndexSet& reachableTiles = context.GetReachedTiles();
+
+	for( auto it = reachableTiles.begin(); it != reachableTiles.end(); ++it )
+	{
+		Vec2s tilePos = mMap->GetTilePosFromCompactIndex( *it );
+		const TerrainType* terrainType = scenario->TerrainTypes.FindByID( mMap->GetTerrainTypeID( *it ) );
+
+		// Prefer tiles with cover that enemies can't attack next turn.
+		float score = ( terrainType->GetCoverBonus() * COVER_WEIGHT ) - ( mThreatMap.GetThreatCount( tilePos ) * THREAT_WEIGHT );
+
+		Unit* bestTarget = nullptr;
+		int bestDamagePercentage = 0;
+		float bestAttackScore = 0.0f;
+		int nearestTargetDistance = -1;
+
+		for( size_t i = 0; i < mTargets.size(); ++i )
+		{
+			const Target& target = mTargets[ i ];
+			int distance = tilePos.GetManhattanDistanceTo( target.unit->GetTilePos() );
+
+			if( nearestTargetDistance < 0 || distance < nearestTargetDistance )
+			{
+				// Keep track of the nearest target.
+				nearestTargetDistance = distance;
+			}
+
+			if( damagePercentages[ i ] > 0 && attackRange.IsValueInRange( distance ) )
+			{
+				// Score the attack by the expected damage, with a bonus for destroying the target.
+				int expectedDamage = ( damagePercentages[ i ] / 10 );
+				float attackScore = ( damagePercentages[ i ] * 0.1f * DAMAGE_WEIGHT );
+
+				if( expectedDamage >= target.unit->GetHealth() )
+				{
+					attackScore += KILL_BONUS;
+				}
+
+				if( attackScore > bestAttackScore )
+				{
+					// Attack the target that gives the best score from this tile.
+					bestTarget = target.unit;
+					bestDamagePercentage = damagePercentages[ i ];
+					bestAttackScore = attackScore;
+				}
+			}
+		}
+
+		if( nearestTargetDistance > -1 )
+		{
+			// Move toward the enemy.
+			score -= ( nearestTargetDistance * APPROACH_WEIGHT );
+		}
+
+		score += bestAttackScore;
+
+		// Insert the tile into the sorted list of the best candidates.
+		int insertIndex = plan.candidateCount;
+
+		while( insertIndex > 0 && plan.candidates[ insertIndex - 1 ].score < score )
+		{
+			--insertIndex;
+		}
+
+		if( insertIndex < MAX_CANDIDATES_PER_UNIT )
+		{
+			for( int i = std::min( plan.candidateCount, MAX_CANDIDATES_PER_UNIT - 1 ); i > insertIndex; --i )
+			{
+				plan.candidates[ i ] = plan.candidates[ i - 1 ];
+			}
+
+			Candidate& candidate = plan.candidates[ insertIndex ];
+			candidate.tilePos = tilePos;
+			candidate.target = bestTarget;
+			candidate.damagePercentage = bestDamagePercentage;
+			candidate.score = score;
+			plan.candidateCount = std::min( plan.candidateCount + 1, MAX_CANDIDATES_PER_UNIT );
+		}
+	}
+
+	for( int i = 0; i < plan.candidateCount; ++i )
+	{
+		// Build the paths to the best candidates while the search results are still available.
+		mMap->BuildPathFromSearch( context, plan.candidates[ i ].tilePos, plan.candidates[ i ].path );
+	}
+}
+
+
+void AIPlanner::AssignOrders()
+{
+	std::vector< UnitPlan* > plans;
+
+	for( auto it = mUnitPlans.begin(); it != mUnitPlans.end(); ++it )
+	{
+		if( it->candidateCount > 0 )
+		{
+			plans.push_back( &( *it ) );
+		}
+	}
+
+	// Let the Units with the best options choose first.
+	std::sort( plans.begin(), plans.end(), []( const UnitPlan* first, const UnitPlan* second )
+	{
+		return ( first->candidates[ 0 ].score > second->candidates[ 0 ].score );
+	});
+
+	std::vector< Vec2s > claimedTiles;
+	std::vector< std::pair< Unit*, int > > expectedDamage;
+
+	for( auto planIt = plans.begin(); planIt != plans.end(); ++planIt )
+	{
+		UnitPlan* plan = *planIt;
+
+		for( int i = 0; i < plan->candidateCount; ++i )
+		{
+			const Candidate& candidate = plan->candidates[ i ];
+
+			if( std::find( claimedTiles.begin(), claimedTiles.end(), candidate.tilePos ) != claimedTiles.end() )
+			{
+				// If another Unit is already moving to the tile, try the next candidate.
+				continue;
+			}
+
+			auto damageIt = expectedDamage.end();
+
+			if( candidate.target )
+			{
+				for( damageIt = expectedDamage.begin(); damageIt != expectedDamage.end(); ++damageIt )
+				{
+					if( damageIt->first == candidate.target )
+					{
+						break;
+					}
+				}
+
+				if( damageIt != expectedDamage.end() && damageIt->second >= candidate.target->GetHealth() )
+				{
+					// If the target is already expected to be destroyed, try the next candidate.
+					continue;
+				}
+			}
+
+			// Claim the tile and add the expected damage to the target.
+			claimedTiles.push_back( candidate.tilePos );
+
+			if( candidate.target )
+			{
+				if( damageIt == expectedDamage.end() )
+				{
+					expectedDamage.push_back( std::make_pair( candidate.target, 0 ) );
+					damageIt = ( expectedDamage.end() - 1 );
+				}
+
+				damageIt->second += ( candidate.damagePercentage / 10 );
+			}
+
+			// Give the Unit its order.
+			Order order;
+			order.unit = plan->unit;
+			order.target = candidate.target;
+			order.path = candidate.path;
+			order.score = candidate.score;
+			mOrders.push_back( order );
+			break;
+		}
+	}
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Plans the turn for a computer-controlled Faction. Every Unit's move and attack options are scored in parallel
+	 * (each worker thread uses its own SearchContext, since the Map is not modified while planning), then the best
+	 * options are assigned to Units one at a time so no two Units pick the same tile or waste attacks on a target
+	 * that is already expected to die. Planning stops when the time budget runs out; Units that were not evaluated
+	 * in time simply wait.
+	 */
+	class AIPlanner
+	{
+	public:
+		static const int MAX_CANDIDATES_PER_UNIT = 4;
+		static const int MAX_WORKER_COUNT = 4;
+		static const float DEFAULT_TIME_BUDGET_SECONDS;
+
+		/**
+		 * An action chosen for a Unit: move along the path, then attack the target (if there is one).
+		 */
+		struct Order
+		{
+			Unit* unit;
+			Unit* target;
+			Path path;
+			float score;
+		};
+
+		typedef std::vector< Order > Orders;
+
+		AIPlanner();
+		~AIPlanner();
+
+		void SetTimeBudget( float timeBudgetSeconds );
+		float GetTimeBudget() const;
+		void SetWorkerCount( int workerCount );
+		int GetWorkerCount() const;
+
+		void PlanTurn( Map* map, Faction* faction );
+		void ExecuteTurn( Game* game );
+		const Orders& GetOrders() const;
+		bool RanOutOfTime() const;
+
+	private:
+		/**
+		 * A tile a Unit could move to, along with the best attack from that tile.
+		 */
+		struct Candidate
+		{
+			Vec2s tilePos;
+			Unit* target;
+			int damagePercentage;
+			float score;
+			Path path;
+		};
+
+		/**
+		 * The best candidates found for a single Unit.
+		 */
+		struct UnitPlan
+		{
+			Unit* unit;
+			Candidate candidates[ MAX_CANDIDATES_PER_UNIT ];
+			int candidateCount;
+		};
+
+		/**
+		 * An enemy Unit along with its defense bonus.
+		 */
+		struct Target
+		{
+			Unit* unit;
+			float defenseBonus;
+		};
+
+		AIPlanner( const AIPlanner& other );
+		void operator=( const AIPlanner& other );
+
+		void RunWorker( SearchContext& context );
+		void EvaluateUnit( UnitPlan& plan, SearchContext& context ) const;
+		void AssignOrders();
+
+		Map* mMap;
+		Faction* mFaction;
+		float mTimeBudget;
+		int mWorkerCount;
+		double mDeadline;
+		volatile int mNextUnitPlanIndex;
+		volatile bool mRanOutOfTime;
+		ThreatMap mThreatMap;
+		std::vector< Target > mTargets;
+		std::vector< UnitPlan > mUnitPlans;
+		std::vector< SearchContext* > mSearchContexts;
+		Orders mOrders;
+	};
+
+
+	inline float AIPlanner::GetTimeBudget() const
+	{
+		return mTimeBudget;
+	}
+
+
+	inline int AIPlanner::GetWorkerCount() const
+	{
+		return mWorkerCount;
+	}
+
+
+	inline const AIPlanner::Orders& AIPlanner::GetOrders() const
+	{
+		return mOrders;
+	}
+
+
+	inline bool AIPlanner::RanOutOfTime() const
+	{
+		return mRanOutOfTime;
+	}
+}
@@ -1,11 +1,14 @@
-#include "androidwars.h"
+#include "androidwars_sim.h"
 
 using namespace mage;
 
 
 Faction::Faction( Map* map ) :
 	mMap( map ),
-	mFunds( 0 )
+	mFunds( 0 ),
+	mIncome( 0 ),
+	mLivingUnitCount( 0 ),
+	mHasLostHeadquarters( false )
 {
 	assertion( mMap, "Cannot create Faction without a valid Map!" );
 }
@@ -14,19 +17,85 @@ Faction::Faction( Map* map ) :
 Faction::~Faction() { }
 
 
-void Faction::OnTurnStart( int turnIndex )
+void Faction::OnTurnStart( int /* turnIndex */ )
 {
 	// Determine how many funds to give the Faction based on the tiles the Faction owns.
-	int fundsToAdd = CalculateIncome();
+	int fundsToAdd = GetIncome();
+
+#ifdef _DEBUG
+	// Make sure the running income hasn't drifted from the tiles the Faction actually owns.
+	int tileIncome = CalculateIncome();
+	assertion( fundsToAdd == tileIncome, "Running income (%d) for Faction does not match the income of its tiles (%d)!", fundsToAdd, tileIncome );
+#endif
 
 	// Add the funds to the Faction's account.
 	AddFunds( fundsToAdd );
 
+	// Resupply, repair and feed all of the Faction's Units.
+	UpdateUnitsForTurnStart();
+}
+
+
+void Faction::UpdateUnitsForTurnStart()
+{
+	// Copy the state of each living Unit into one contiguous array.
+	mUnitUpkeep.clear();
+
 	for( auto it = mUnits.begin(); it != mUnits.end(); ++it )
 	{
-		// Let each Unit process the next turn.
 		Unit* unit = *it;
-		unit->OnTurnStart( turnIndex );
+
+		if( unit->IsAlive() )
+		{
+			UnitUpkeep upkeep;
+			upkeep.unit = unit;
+			upkeep.tileIndex = mMap->GetCompactTileIndex( unit->GetTilePos() );
+			upkeep.health = unit->mHealth;
+			upkeep.ammo = unit->mAmmo;
+			upkeep.supplies = unit->mSupplies;
+			upkeep.isStarved = false;
+			mUnitUpkeep.push_back( upkeep );
+		}
+	}
+
+	for( auto it = mUnitUpkeep.begin(); it != mUnitUpkeep.end(); ++it )
+	{
+		const UnitType* unitType = it->unit->mUnitType;
+		const MovementType* movementType = unitType->GetMovementType();
+
+		// Consume supplies.
+		it->supplies = std::max( it->supplies - movementType->GetSuppliesConsumedPerTurn(), 0 );
+
+		if( mMap->GetTileOwner( it->tileIndex ) == this )
+		{
+			// If the Unit starts its turn on a tile owned by the Faction, repair and resupply it.
+			it->health = std::min( it->health + Unit::REPAIR_AMOUNT, Unit::MAX_HEALTH );
+			it->ammo = unitType->GetMaxAmmo();
+			it->supplies = unitType->GetMaxSupplies();
+		}
+
+		// Units that need supplies to survive die when they run out.
+		it->isStarved = ( movementType->RequiresSuppliesToSurvive() && it->supplies == 0 );
+	}
+
+	for( auto it = mUnitUpkeep.begin(); it != mUnitUpkeep.end(); ++it )
+	{
+		Unit* unit = it->unit;
+
+		if( it->health != unit->mHealth || it->ammo != unit->mAmmo || it->supplies != unit->mSupplies )
+		{
+			// Copy the new state back to the Unit, and only notify listeners for Units that actually changed.
+			unit->mHealth = it->health;
+			unit->mAmmo = it->ammo;
+			unit->mSupplies = it->supplies;
+			unit->OnStatsChanged.Invoke();
+		}
+
+		if( it->isStarved )
+		{
+			// If the Unit ran out of supplies and it needs them to survive, kill it.
+			unit->Die();
+		}
 	}
 }
 
@@ -61,20 +130,16 @@ void Faction::AddFunds( int funds )
 }
 
 
-int Faction::CalculateIncome() const
+int Faction::GetIncome() const
 {
-	int income = 0;
-
-	for( auto it = mTiles.begin(); it != mTiles.end(); ++it )
-	{
-		Map::Iterator tile = *it;
+	return mIncome;
+}
 
-		// Get the income for each Tile from its TerrainType.
-		assertion( tile->HasTerrainType(), "Cannot get income for tile (%d,%d) because it does not have a valid TerrainType!", tile.GetX(), tile.GetY() );
-		income += tile->GetTerrainType()->GetIncome();
-	}
 
-	return income;
+int Faction::CalculateIncome() const
+{
+	// Let the Map add up the income from its dense tile data (GetIncome returns the same value without visiting every tile).
+	return mMap->CalculateIncome( this );
 }
 
 
@@ -102,6 +167,36 @@ bool Faction::HasUnits() const
 }
 
 
+size_t Faction::GetLivingUnitCount() const
+{
+	return mLivingUnitCount;
+}
+
+
+bool Faction::HasLivingUnits() const
+{
+	return ( mLivingUnitCount > 0 );
+}
+
+
+bool Faction::HasActiveUnits() const
+{
+	bool result = false;
+
+	for( auto it = mUnits.begin(); it != mUnits.end(); ++it )
+	{
+		if( ( *it )->IsAlive() && ( *it )->IsActive() )
+		{
+			// If any living Unit can still act this turn, the Faction isn't done.
+			result = true;
+			break;
+		}
+	}
+
+	return result;
+}
+
+
 const Faction::Tiles& Faction::GetTiles() const
 {
 	return mTiles;
@@ -123,12 +218,14 @@ bool Faction::HasTiles() const
 void Faction::SetHeadquarters( Map::Iterator tile )
 {
 	mHeadquarters = tile;
+	mHasLostHeadquarters = false;
 }
 
 
 void Faction::ClearHeadquarters()
 {
 	mHeadquarters = Map::Iterator();
+	mHasLostHeadquarters = false;
 }
 
 
@@ -144,6 +241,19 @@ bool Faction::HasHeadquarters() const
 }
 
 
+bool Faction::HasLostHeadquarters() const
+{
+	return mHasLostHeadquarters;
+}
+
+
+bool Faction::IsDefeated() const
+{
+	// A Faction loses when its headquarters is captured or when all of its Units have been destroyed.
+	return ( mHasLostHeadquarters || ( HasUnits() && !HasLivingUnits() ) );
+}
+
+
 void Faction::SetColor( const Color& color )
 {
 	mColor = color;
@@ -159,26 +269,64 @@ Color Faction::GetColor() const
 void Faction::UnitGained( Unit* unit )
 {
 	// Keep track of the Units owned by this Faction.
-	mUnits.insert( unit );
+	if( mUnits.insert( unit ).second && unit->IsAlive() )
+	{
+		++mLivingUnitCount;
+	}
 }
 
 
 void Faction::UnitLost( Unit* unit )
 {
 	// Keep track of the Units owned by this Faction.
-	mUnits.erase( unit );
+	if( mUnits.erase( unit ) > 0 && unit->IsAlive() )
+	{
+		--mLivingUnitCount;
+	}
+}
+
+
+void Faction::UnitDied( Unit* unit )
+{
+	assertion( mUnits.find( unit ) != mUnits.end(), "Faction was notified of the death of a Unit that it does not own!" );
+
+	// Keep track of how many of this Faction's Units are still alive.
+	--mLivingUnitCount;
 }
 
 
 void Faction::TileGained( const Map::Iterator& tile )
 {
-	// Keep track of the Units owned by this Faction.
-	mTiles.insert( tile );
+	// Keep track of the tiles owned by this Faction.
+	if( mTiles.insert( tile ).second && tile->HasTerrainType() )
+	{
+		// Add the income from the tile.
+		mIncome += tile->GetTerrainType()->GetIncome();
+	}
 }
 
 
 void Faction::TileLost( const Map::Iterator& tile )
 {
-	// Keep track of the Units owned by this Faction.
-	mTiles.insert( tile );
+	// Keep track of the tiles owned by this Faction.
+	if( mTiles.erase( tile ) > 0 && tile->HasTerrainType() )
+	{
+		// Remove the income from the tile.
+		mIncome -= tile->GetTerrainType()->GetIncome();
+	}
+
+	if( tile == mHeadquarters )
+	{
+		// If the Faction lost its headquarters, remember it (so the Game can declare the Faction defeated).
+		mHeadquarters = Map::Iterator();
+		mHasLostHeadquarters = true;
+	}
+}
+
+
+void Faction::TileTerrainTypeChanged( const TerrainType* oldTerrainType, const TerrainType* newTerrainType )
+{
+	// Replace the income from the old TerrainType with the income from the new one.
+	mIncome -= ( oldTerrainType ? oldTerrainType->GetIncome() : 0 );
+	mIncome += ( newTerrainType ? newTerrainType->GetIncome() : 0 );
 }
@@ -12,12 +12,16 @@ namespace mage
 
 		void SetFunds( int funds );
 		void AddFunds( int funds );
+		int GetIncome() const;
 		int CalculateIncome() const;
 		int GetFunds() const;
 
 		const Units& GetUnits() const;
 		size_t GetUnitCount() const;
 		bool HasUnits() const;
+		size_t GetLivingUnitCount() const;
+		bool HasLivingUnits() const;
+		bool HasActiveUnits() const;
 
 		const Tiles& GetTiles() const;
 		size_t GetTileCount() const;
@@ -27,32 +31,56 @@ namespace mage
 		void ClearHeadquarters();
 		Map::Iterator GetHeadquarters() const;
 		bool HasHeadquarters() const;
+		bool HasLostHeadquarters() const;
+
+		bool IsDefeated() const;
 
 		void SetColor( const Color& color );
 		Color GetColor() const;
 
 	private:
+		/**
+		 * A copy of the state of a Unit that is updated while the start of a turn is processed.
+		 */
+		struct UnitUpkeep
+		{
+			Unit* unit;
+			size_t tileIndex;
+			int health;
+			int ammo;
+			int supplies;
+			bool isStarved;
+		};
+
 		Faction( Map* map );
 		~Faction();
 
 		void OnTurnStart( int turnIndex );
 		void OnTurnEnd( int turnIndex );
+		void UpdateUnitsForTurnStart();
 
 		void UnitGained( Unit* unit );
 		void UnitLost( Unit* unit );
+		void UnitDied( Unit* unit );
 
 		void TileGained( const Map::Iterator& tile );
 		void TileLost( const Map::Iterator& tile );
+		void TileTerrainTypeChanged( const TerrainType* oldTerrainType, const TerrainType* newTerrainType );
 
 		int mFunds;
+		int mIncome;
+		size_t mLivingUnitCount;
+		bool mHasLostHeadquarters;
 		Map* mMap;
 		Color mColor;
 		Map::Iterator mHeadquarters;
 		Units mUnits;
 		Tiles mTiles;
+		std::vector< UnitUpkeep > mUnitUpkeep;
 
 		friend class Game;
 		friend class Map;
+		friend class Tile;
 		friend class Unit;
 	};
 }
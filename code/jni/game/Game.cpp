@@ -1,13 +1,14 @@
-#include "androidwars.h"
+#include "androidwars_sim.h"
 
 using namespace mage;
 
 
 Game::Game() :
-	mStatus( STATUS_NOT_STARTED ),
-	mCamera( nullptr ),
 	mCurrentTurnIndex( -1 ),
-	mCurrentPlayerIndex( -1 )
+	mCurrentPlayerIndex( -1 ),
+	mMap( nullptr ),
+	mCamera( nullptr ),
+	mStatus( STATUS_NOT_STARTED )
 { }
 
 
@@ -25,13 +26,19 @@ void Game::Init( Map* map )
 	// Store a pointer to the Map for this Game.
 	mMap = map;
 	assertion( mMap, "Cannot create game without a valid Map!" );
+}
+
+
+void Game::Start()
+{
+	assertion( IsInitialized(), "Cannot start Game that has not been initialized!" );
 
 	// Make sure the number of Players makes sense.
 	size_t playerCount = GetPlayerCount();
 	size_t maxPlayerCount = mMap->GetFactionCount();
 
-	assertion( maxPlayerCount >= MIN_PLAYER_COUNT, "Cannot start Game with fewer than %d players! (%d requested)", MIN_PLAYER_COUNT, maxPlayerCount );
-	assertion( maxPlayerCount <= maxPlayerCount, "Cannot start Game with %d players because there are only %d Factions for the current Map!", playerCount, maxPlayerCount );
+	assertion( playerCount >= MIN_PLAYER_COUNT, "Cannot start Game with fewer than %d players! (%d requested)", MIN_PLAYER_COUNT, playerCount );
+	assertion( playerCount <= maxPlayerCount, "Cannot start Game with %d players because there are only %d Factions for the current Map!", playerCount, maxPlayerCount );
 
 	// Make sure the game hasn't been started yet.
 	assertion( IsNotStarted(), "Cannot start Game that has already been started!" );
@@ -88,6 +95,22 @@ void Game::LoadState( const rapidjson::Document& gameData )
 {
 	// TODO: Load turn info.
 
+	if( gameData.HasMember( "random" ) )
+	{
+		const rapidjson::Value& randomObject = gameData[ "random" ];
+
+		if( randomObject.IsObject() && randomObject.HasMember( "state" ) && randomObject[ "state" ].IsUint64() &&
+			randomObject.HasMember( "increment" ) && randomObject[ "increment" ].IsUint64() )
+		{
+			// Restore the random stream so the Game continues exactly where it left off.
+			mRandom.SetState( randomObject[ "state" ].GetUint64(), randomObject[ "increment" ].GetUint64() );
+		}
+		else
+		{
+			WarnFail( "Could not load random state from JSON because the \"random\" property is not valid!" );
+		}
+	}
+
 	if( gameData.HasMember( "map" ) )
 	{
 		const rapidjson::Value& mapObject = gameData[ "map" ];
@@ -95,7 +118,7 @@ void Game::LoadState( const rapidjson::Document& gameData )
 		if( mapObject.IsObject() )
 		{
 			// Load Map state.
-			mMap->LoadFromJSON( gameData );
+			mMap->LoadFromJSON( mapObject );
 		}
 		else
 		{
@@ -114,10 +137,36 @@ void Game::SaveState( rapidjson::Document& result )
 	// TODO: Save Game info.
 	rapidjson::Value mapData;
 	mapData.SetObject();
-	result.AddMember( "map", mapData, result.GetAllocator() );
 
-	// Save the Map.
+	// Save the Map (before adding it to the result, which moves the value).
 	mMap->SaveToJSON( result, mapData );
+	result.AddMember( "map", mapData, result.GetAllocator() );
+
+	// Save the random stream, so replays and validation produce the same results.
+	rapidjson::Value randomData;
+	randomData.SetObject();
+
+	rapidjson::Value stateValue;
+	stateValue.SetUint64( mRandom.GetState() );
+	randomData.AddMember( "state", stateValue, result.GetAllocator() );
+
+	rapidjson::Value incrementValue;
+	incrementValue.SetUint64( mRandom.GetIncrement() );
+	randomData.AddMember( "increment", incrementValue, result.GetAllocator() );
+
+	result.AddMember( "random", randomData, result.GetAllocator() );
+}
+
+
+void Game::SetRandomSeed( uint64 seed )
+{
+	mRandom.Seed( seed );
+}
+
+
+RandomStream& Game::GetRandom()
+{
+	return mRandom;
 }
 
 /*
@@ -203,6 +252,12 @@ int Game::GetCurrentPlayerIndex() const
 }
 
 
+int Game::GetTurnNumber() const
+{
+	return mCurrentTurnIndex;
+}
+
+
 Player* Game::GetCurrentPlayer() const
 {
 	return GetPlayerByIndex( mCurrentPlayerIndex );
@@ -215,6 +270,12 @@ size_t Game::GetPlayerCount() const
 }
 
 
+const Game::Players& Game::GetPlayers() const
+{
+	return mPlayers;
+}
+
+
 /*
 void Game::SelectReachableTilesForUnit( Unit* unit, const Vec2i& tilePos, int totalCostToEnter, CardinalDirection previousTileDirection, int movementRange )
 {
@@ -333,7 +394,29 @@ void Game::OnUnitReachedDestination( Unit* unit )
 
 void Game::EnforceVictoryConditions()
 {
-	// TODO
+	size_t remainingPlayerCount = 0;
+
+	for( auto it = mPlayers.begin(); it != mPlayers.end(); ++it )
+	{
+		// Factions keep their own unit counts and headquarters status, so this doesn't depend on the size of the Map.
+		if( !( *it )->GetFaction()->IsDefeated() )
+		{
+			++remainingPlayerCount;
+		}
+	}
+
+	if( remainingPlayerCount <= 1 )
+	{
+		// If only one Player is left, the Game is over.
+		GameOver();
+	}
+}
+
+
+void Game::GameOver()
+{
+	DebugPrintf( "Game over on turn %d.", mCurrentTurnIndex );
+	mStatus = STATUS_GAME_OVER;
 }
 
 
@@ -359,6 +442,15 @@ void Game::NextTurn()
 		OnTurnEnd.Invoke( mCurrentTurnIndex, GetCurrentPlayer() );
 	}
 
+	// Check whether any Player has won.
+	EnforceVictoryConditions();
+
+	if( mStatus != STATUS_IN_PROGRESS )
+	{
+		// If the Game is over, don't start another turn.
+		return;
+	}
+
 	// Increment the turn counter.
 	++mCurrentTurnIndex;
 
@@ -368,3 +460,17 @@ void Game::NextTurn()
 	// Start the next turn.
 	StartTurn();
 }
+
+
+void Game::PlayComputerTurn()
+{
+	assertion( mStatus == STATUS_IN_PROGRESS, "Cannot play computer turn for Game that is not in progress!" );
+
+	Player* player = GetCurrentPlayer();
+	assertion( player->IsComputerControlled(), "Cannot play computer turn for user-controlled Player!" );
+
+	// Plan and carry out the turn for the current Player, then move on to the next turn.
+	mAIPlanner.PlanTurn( mMap, player->GetFaction() );
+	mAIPlanner.ExecuteTurn( this );
+	NextTurn();
+}
@@ -3,6 +3,7 @@
 
 namespace mage
 {
+	class Camera;
 	class Player;
 	class Unit;
 
@@ -29,6 +30,7 @@ namespace mage
 
 		void Init( Map* map );
 		bool IsInitialized() const;
+		void Start();
 		Status GetStatus() const;
 		bool IsNotStarted() const;
 		bool IsInProgress() const;
@@ -38,6 +40,9 @@ namespace mage
 		void LoadState( const rapidjson::Document& state );
 		void SaveState( rapidjson::Document& result );
 
+		void SetRandomSeed( uint64 seed );
+		RandomStream& GetRandom();
+
 		Player* CreatePlayer( Faction* faction );
 		Player* GetPlayerByIndex( int index ) const;
 		int GetCurrentPlayerIndex() const;
@@ -48,6 +53,7 @@ namespace mage
 		void DestroyAllPlayers();
 
 		void NextTurn();
+		void PlayComputerTurn();
 		int GetTurnNumber() const;
 		Event< int, Player* > OnTurnStart;
 		Event< int, Player* > OnTurnEnd;
@@ -71,6 +77,8 @@ namespace mage
 		Camera* mCamera;
 		Status mStatus;
 		Players mPlayers;
+		RandomStream mRandom;
+		AIPlanner mAIPlanner;
 
 		friend class Unit;
 	};
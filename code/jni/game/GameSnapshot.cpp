@@ -0,0 +1,376 @@
+#include "androidwars_sim.h"
+
+using namespace mage;
+
+
+namespace
+{
+	short FindFactionIndex( const Map::Factions& factions, const Faction* faction )
+	{
+		auto it = std::find( factions.begin(), factions.end(), faction );
+		return ( it != factions.end() ? (short) ( it - factions.begin() ) : GameSnapshot::NO_FACTION );
+	}
+}
+
+
+const short GameSnapshot::NO_FACTION;
+const short GameSnapshot::NO_UNIT;
+const int GameSnapshot::NO_TILE;
+
+
+GameSnapshot::GameSnapshot() :
+	mScenario( nullptr ),
+	mWidth( 0 ),
+	mHeight( 0 ),
+	mTurnIndex( 0 ),
+	mCurrentPlayerIndex( 0 )
+{ }
+
+
+GameSnapshot::~GameSnapshot() { }
+
+
+void GameSnapshot::Capture( Game* game )
+{
+	assertion( game, "Cannot capture GameSnapshot of null Game!" );
+	assertion( game->IsInitialized(), "Cannot capture GameSnapshot of Game that has not been initialized!" );
+	assertion( game->GetPlayerCount() > 0, "Cannot capture GameSnapshot of Game with no Players!" );
+
+	Map* map = game->GetMap();
+	const Map::Factions& factions = map->GetFactions();
+
+	mScenario = map->GetScenario();
+	mWidth = map->GetWidth();
+	mHeight = map->GetHeight();
+	mTurnIndex = std::max( game->GetTurnNumber(), 0 );
+	mCurrentPlayerIndex = std::max( game->GetCurrentPlayerIndex(), 0 );
+	mRandom = game->GetRandom();
+
+	// Copy the funds and defeat conditions of each Faction.
+	mFactions.resize( factions.size() );
+
+	for( size_t i = 0; i < factions.size(); ++i )
+	{
+		const Faction* faction = factions[ i ];
+		FactionState& state = mFactions[ i ];
+		state.funds = faction->GetFunds();
+		state.headquartersTileIndex = ( faction->HasHeadquarters() ? (int) map->GetCompactTileIndex( faction->GetHeadquarters().GetPosition() ) : NO_TILE );
+		state.hasLostHeadquarters = faction->HasLostHeadquarters();
+		state.hasHadUnits = faction->HasUnits();
+	}
+
+	// Copy the turn order.
+	const Game::Players& players = game->GetPlayers();
+	mPlayerFactionIndices.resize( players.size() );
+
+	for( size_t i = 0; i < players.size(); ++i )
+	{
+		mPlayerFactionIndices[ i ] = FindFactionIndex( factions, players[ i ]->GetFaction() );
+	}
+
+	// Copy the tile data.
+	size_t tileCount = ( (size_t) mWidth * (size_t) mHeight );
+	mTerrainTypeIDs.resize( tileCount );
+	mTileOwnerIndices.resize( tileCount );
+	mTileUnitIndices.assign( tileCount, NO_UNIT );
+
+	for( size_t i = 0; i < tileCount; ++i )
+	{
+		mTerrainTypeIDs[ i ] = map->GetTerrainTypeID( i );
+		mTileOwnerIndices[ i ] = FindFactionIndex( factions, map->GetTile( map->GetTilePosFromCompactIndex( i ) )->GetOwner() );
+	}
+
+	// Copy the living Units (dead Units can't affect the outcome of the Game).
+	const Map::Units& units = map->GetUnits();
+	mUnits.clear();
+	mUnits.reserve( units.size() );
+
+	for( auto it = units.begin(); it != units.end(); ++it )
+	{
+		const Unit* unit = *it;
+
+		if( !unit->IsAlive() )
+		{
+			continue;
+		}
+
+		UnitState state;
+		state.unitTypeID = (short) unit->GetUnitType()->GetID();
+		state.ownerIndex = FindFactionIndex( factions, unit->GetOwner() );
+		state.tileX = unit->GetTileX();
+		state.tileY = unit->GetTileY();
+		state.health = (short) unit->GetHealth();
+		state.ammo = (short) unit->GetAmmo();
+		state.supplies = (short) unit->GetSupplies();
+		state.isAlive = true;
+		state.isActive = unit->IsActive();
+
+		mTileUnitIndices[ GetTileIndex( state.tileX, state.tileY ) ] = (short) mUnits.size();
+		mUnits.push_back( state );
+	}
+}
+
+
+void GameSnapshot::SetTileOwner( size_t tileIndex, short factionIndex )
+{
+	short previousOwnerIndex = mTileOwnerIndices[ tileIndex ];
+	mTileOwnerIndices[ tileIndex ] = factionIndex;
+
+	if( previousOwnerIndex != NO_FACTION && previousOwnerIndex != factionIndex )
+	{
+		FactionState& previousOwner = mFactions[ previousOwnerIndex ];
+
+		if( previousOwner.headquartersTileIndex == (int) tileIndex )
+		{
+			// If the Faction lost its headquarters, remember it (the same as Faction::TileLost).
+			previousOwner.headquartersTileIndex = NO_TILE;
+			previousOwner.hasLostHeadquarters = true;
+		}
+	}
+}
+
+
+int GameSnapshot::GetLivingUnitCount( int factionIndex ) const
+{
+	int result = 0;
+
+	for( auto it = mUnits.begin(); it != mUnits.end(); ++it )
+	{
+		if( it->isAlive && it->ownerIndex == factionIndex )
+		{
+			++result;
+		}
+	}
+
+	return result;
+}
+
+
+int GameSnapshot::CalculateIncome( int factionIndex ) const
+{
+	int income = 0;
+
+	for( size_t i = 0; i < mTileOwnerIndices.size(); ++i )
+	{
+		if( mTileOwnerIndices[ i ] == factionIndex )
+		{
+			// Add the income for each tile owned by the Faction.
+			income += mScenario->TerrainTypes.FindByID( mTerrainTypeIDs[ i ] )->GetIncome();
+		}
+	}
+
+	return income;
+}
+
+
+bool GameSnapshot::IsDefeated( int factionIndex ) const
+{
+	// A Faction loses when its headquarters is captured or when all of its Units have been destroyed.
+	const FactionState& faction = GetFaction( factionIndex );
+	return ( faction.hasLostHeadquarters || ( faction.hasHadUnits && GetLivingUnitCount( factionIndex ) == 0 ) );
+}
+
+
+int GameSnapshot::GetWinningFactionIndex() const
+{
+	int result = NO_FACTION;
+
+	for( auto it = mPlayerFactionIndices.begin(); it != mPlayerFactionIndices.end(); ++it )
+	{
+		if( !IsDefeated( *it ) )
+		{
+			if( result != NO_FACTION )
+			{
+				// If more than one Faction is still undefeated, nobody has won yet.
+				return NO_FACTION;
+			}
+
+			result = *it;
+		}
+	}
+
+	return result;
+}
+
+
+void GameSnapshot::MoveUnit( int unitIndex, short tileX, short tileY, int pathCost )
+{
+	UnitState& unit = mUnits[ unitIndex ];
+	assertion( unit.isAlive, "Cannot move dead Unit %d in GameSnapshot!", unitIndex );
+	assertion( IsValidTilePos( tileX, tileY ), "Cannot move Unit %d to invalid tile (%d,%d) in GameSnapshot!", unitIndex, tileX, tileY );
+
+	size_t tileIndex = GetTileIndex( tileX, tileY );
+	assertion( mTileUnitIndices[ tileIndex ] == NO_UNIT || mTileUnitIndices[ tileIndex ] == unitIndex,
+			   "Cannot move Unit %d to tile (%d,%d) in GameSnapshot because the tile is occupied!", unitIndex, tileX, tileY );
+
+	// Move the Unit to the destination tile.
+	mTileUnitIndices[ GetTileIndex( unit.tileX, unit.tileY ) ] = NO_UNIT;
+	mTileUnitIndices[ tileIndex ] = (short) unitIndex;
+	unit.tileX = tileX;
+	unit.tileY = tileY;
+
+	// Consume supplies equal to the cost of traversing the path.
+	unit.supplies = (short) std::max( unit.supplies - pathCost, 0 );
+}
+
+
+bool GameSnapshot::CanAttack( int attackerIndex, int targetIndex ) const
+{
+	const UnitState& attacker = mUnits[ attackerIndex ];
+	const UnitState& target = mUnits[ targetIndex ];
+
+	if( !attacker.isAlive || !target.isAlive )
+	{
+		return false;
+	}
+
+	// Check whether the target is in range.
+	const UnitType* attackerType = mScenario->UnitTypes.FindByID( attacker.unitTypeID );
+	int distance = ( std::abs( target.tileX - attacker.tileX ) + std::abs( target.tileY - attacker.tileY ) );
+
+	if( !attackerType->GetAttackRange().IsValueInRange( distance ) )
+	{
+		return false;
+	}
+
+	// Check whether the attacker has a weapon that can target the other Unit.
+	return ( GetBestAvailableWeaponAgainst( attackerIndex, targetIndex ) > -1 );
+}
+
+
+int GameSnapshot::GetBestAvailableWeaponAgainst( int attackerIndex, int targetIndex ) const
+{
+	const UnitState& attacker = mUnits[ attackerIndex ];
+	const UnitType* attackerType = mScenario->UnitTypes.FindByID( attacker.unitTypeID );
+	const UnitType* targetType = mScenario->UnitTypes.FindByID( mUnits[ targetIndex ].unitTypeID );
+
+	// Choose the most damaging weapon that can currently fire at the target.
+	return Unit::ChooseBestWeaponAgainst( mScenario, attackerType, attacker.ammo, targetType );
+}
+
+
+int GameSnapshot::CalculateDamagePercentage( int attackerIndex, int targetIndex, int weaponIndex ) const
+{
+	const UnitState& attacker = mUnits[ attackerIndex ];
+	const UnitState& target = mUnits[ targetIndex ];
+	const UnitType* attackerType = mScenario->UnitTypes.FindByID( attacker.unitTypeID );
+
+	// Get the base amount of damage to apply.
+	int baseDamagePercentage = mScenario->GetDamagePercentagesByUnitTypeID( attackerType, weaponIndex )[ target.unitTypeID ];
+
+	// Scale the damage by the health of the attacker and the defense bonus of the target.
+	const TerrainType* targetTerrainType = mScenario->TerrainTypes.FindByID( mTerrainTypeIDs[ GetTileIndex( target.tileX, target.tileY ) ] );
+	float targetDefenseBonus = Unit::CalculateDefenseBonus( targetTerrainType, target.health );
+	return Unit::ScaleDamagePercentage( baseDamagePercentage, attacker.health, targetDefenseBonus );
+}
+
+
+void GameSnapshot::Attack( int attackerIndex, int targetIndex )
+{
+	// Get the best weapon to use against the target.
+	int weaponIndex = GetBestAvailableWeaponAgainst( attackerIndex, targetIndex );
+	assertion( weaponIndex > -1, "Cannot attack in GameSnapshot: No weapon of Unit %d can currently target Unit %d!", attackerIndex, targetIndex );
+
+	UnitState& attacker = mUnits[ attackerIndex ];
+	UnitState& target = mUnits[ targetIndex ];
+	const Weapon& weapon = mScenario->UnitTypes.FindByID( attacker.unitTypeID )->GetWeaponByIndex( weaponIndex );
+
+	// Roll for the amount of damage to apply.
+	int damagePercentage = CalculateDamagePercentage( attackerIndex, targetIndex, weaponIndex );
+	int totalDamage = Unit::RollDamage( damagePercentage, mRandom );
+
+	target.health = (short) std::max( target.health - totalDamage, 0 );
+
+	if( target.health == 0 )
+	{
+		// If the target runs out of health, kill it.
+		KillUnit( targetIndex );
+	}
+
+	if( weapon.ConsumesAmmo() )
+	{
+		// Consume ammo equal to the amount that the weapon uses per shot.
+		attacker.ammo = (short) std::max( attacker.ammo - weapon.GetAmmoPerShot(), 0 );
+	}
+}
+
+
+void GameSnapshot::NextTurn()
+{
+	// End the current turn.
+	EndTurn();
+
+	// Choose the next Player to take a turn.
+	++mTurnIndex;
+	mCurrentPlayerIndex = ( ( mCurrentPlayerIndex + 1 ) % GetPlayerCount() );
+
+	// Start the next turn.
+	StartTurn();
+}
+
+
+void GameSnapshot::StartTurn()
+{
+	int factionIndex = GetCurrentFactionIndex();
+
+	// Give the Faction its income.
+	mFactions[ factionIndex ].funds += CalculateIncome( factionIndex );
+
+	for( size_t i = 0; i < mUnits.size(); ++i )
+	{
+		UnitState& unit = mUnits[ i ];
+
+		if( !unit.isAlive || unit.ownerIndex != factionIndex )
+		{
+			continue;
+		}
+
+		// Consume supplies (the same as Faction::UpdateUnitsForTurnStart).
+		const UnitType* unitType = mScenario->UnitTypes.FindByID( unit.unitTypeID );
+		const MovementType* movementType = unitType->GetMovementType();
+		unit.supplies = (short) std::max( unit.supplies - movementType->GetSuppliesConsumedPerTurn(), 0 );
+
+		if( mTileOwnerIndices[ GetTileIndex( unit.tileX, unit.tileY ) ] == factionIndex )
+		{
+			// If the Unit starts its turn on a tile owned by the Faction, repair and resupply it.
+			unit.health = (short) std::min( unit.health + Unit::REPAIR_AMOUNT, Unit::MAX_HEALTH );
+			unit.ammo = (short) unitType->GetMaxAmmo();
+			unit.supplies = (short) unitType->GetMaxSupplies();
+		}
+
+		if( movementType->RequiresSuppliesToSurvive() && unit.supplies == 0 )
+		{
+			// If the Unit runs out of supplies and it needs them to survive, kill it.
+			KillUnit( (int) i );
+		}
+	}
+}
+
+
+void GameSnapshot::EndTurn()
+{
+	int factionIndex = GetCurrentFactionIndex();
+
+	for( auto it = mUnits.begin(); it != mUnits.end(); ++it )
+	{
+		if( it->ownerIndex == factionIndex )
+		{
+			// Reactivate the Faction's Units.
+			it->isActive = true;
+		}
+	}
+}
+
+
+void GameSnapshot::KillUnit( int unitIndex )
+{
+	UnitState& unit = mUnits[ unitIndex ];
+
+	if( unit.isAlive )
+	{
+		// Mark the Unit as dead and free its tile.
+		unit.isAlive = false;
+		unit.health = 0;
+		mTileUnitIndices[ GetTileIndex( unit.tileX, unit.tileY ) ] = NO_UNIT;
+	}
+}
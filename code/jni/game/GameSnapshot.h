@@ -0,0 +1,220 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * A compact copy of the state of a Game (tiles, Units, funds and turn order) that can be copied and simulated
+	 * cheaply. Units and Factions are referred to by index instead of by pointer, and the snapshot has no events,
+	 * so simulating a snapshot never affects the Game it was captured from. The Scenario is shared (read only)
+	 * between all snapshots of the same Game.
+	 */
+	class GameSnapshot
+	{
+	public:
+		static const short NO_FACTION = -1;
+		static const short NO_UNIT = -1;
+		static const int NO_TILE = -1;
+
+		/**
+		 * The state of a single Faction.
+		 */
+		struct FactionState
+		{
+			int funds;
+			int headquartersTileIndex;
+			bool hasLostHeadquarters;
+			bool hasHadUnits;
+		};
+
+		/**
+		 * The state of a single Unit.
+		 */
+		struct UnitState
+		{
+			short unitTypeID;
+			short ownerIndex;
+			short tileX;
+			short tileY;
+			short health;
+			short ammo;
+			short supplies;
+			bool isAlive;
+			bool isActive;
+		};
+
+		GameSnapshot();
+		~GameSnapshot();
+
+		void Capture( Game* game );
+
+		const Scenario* GetScenario() const;
+
+		short GetWidth() const;
+		short GetHeight() const;
+		bool IsValidTilePos( short tileX, short tileY ) const;
+		size_t GetTileIndex( short tileX, short tileY ) const;
+		short GetTerrainTypeID( size_t tileIndex ) const;
+		short GetTileOwnerIndex( size_t tileIndex ) const;
+		short GetTileUnitIndex( size_t tileIndex ) const;
+		void SetTileOwner( size_t tileIndex, short factionIndex );
+
+		int GetUnitCount() const;
+		const UnitState& GetUnit( int unitIndex ) const;
+		int GetLivingUnitCount( int factionIndex ) const;
+
+		int GetFactionCount() const;
+		const FactionState& GetFaction( int factionIndex ) const;
+		int GetFunds( int factionIndex ) const;
+		int CalculateIncome( int factionIndex ) const;
+		bool IsDefeated( int factionIndex ) const;
+
+		int GetPlayerCount() const;
+		int GetCurrentPlayerIndex() const;
+		int GetCurrentFactionIndex() const;
+		int GetTurnIndex() const;
+		int GetWinningFactionIndex() const;
+
+		void MoveUnit( int unitIndex, short tileX, short tileY, int pathCost );
+		bool CanAttack( int attackerIndex, int targetIndex ) const;
+		int GetBestAvailableWeaponAgainst( int attackerIndex, int targetIndex ) const;
+		int CalculateDamagePercentage( int attackerIndex, int targetIndex, int weaponIndex ) const;
+		void Attack( int attackerIndex, int targetIndex );
+
+		void NextTurn();
+
+		RandomStream& GetRandom();
+
+	private:
+		void StartTurn();
+		void EndTurn();
+		void KillUnit( int unitIndex );
+
+		const Scenario* mScenario;
+		short mWidth;
+		short mHeight;
+		int mTurnIndex;
+		int mCurrentPlayerIndex;
+		RandomStream mRandom;
+
+		// Faction index of each Player (in turn order), and the state of each Faction (indexed by Faction index).
+		std::vector< short > mPlayerFactionIndices;
+		std::vector< FactionState > mFactions;
+
+		// Dense per-tile data (indexed by tile index).
+		std::vector< short > mTerrainTypeIDs;
+		std::vector< short > mTileOwnerIndices;
+		std::vector< short > mTileUnitIndices;
+
+		std::vector< UnitState > mUnits;
+	};
+
+
+	inline const Scenario* GameSnapshot::GetScenario() const
+	{
+		return mScenario;
+	}
+
+
+	inline short GameSnapshot::GetWidth() const
+	{
+		return mWidth;
+	}
+
+
+	inline short GameSnapshot::GetHeight() const
+	{
+		return mHeight;
+	}
+
+
+	inline bool GameSnapshot::IsValidTilePos( short tileX, short tileY ) const
+	{
+		return ( tileX >= 0 && tileY >= 0 && tileX < mWidth && tileY < mHeight );
+	}
+
+
+	inline size_t GameSnapshot::GetTileIndex( short tileX, short tileY ) const
+	{
+		return ( (size_t) tileY * (size_t) mWidth + (size_t) tileX );
+	}
+
+
+	inline short GameSnapshot::GetTerrainTypeID( size_t tileIndex ) const
+	{
+		return mTerrainTypeIDs[ tileIndex ];
+	}
+
+
+	inline short GameSnapshot::GetTileOwnerIndex( size_t tileIndex ) const
+	{
+		return mTileOwnerIndices[ tileIndex ];
+	}
+
+
+	inline short GameSnapshot::GetTileUnitIndex( size_t tileIndex ) const
+	{
+		return mTileUnitIndices[ tileIndex ];
+	}
+
+
+	inline int GameSnapshot::GetUnitCount() const
+	{
+		return (int) mUnits.size();
+	}
+
+
+	inline const GameSnapshot::UnitState& GameSnapshot::GetUnit( int unitIndex ) const
+	{
+		assertion( unitIndex >= 0 && unitIndex < GetUnitCount(), "Cannot get Unit %d from GameSnapshot because the index is out of range!", unitIndex );
+		return mUnits[ unitIndex ];
+	}
+
+
+	inline int GameSnapshot::GetFactionCount() const
+	{
+		return (int) mFactions.size();
+	}
+
+
+	inline const GameSnapshot::FactionState& GameSnapshot::GetFaction( int factionIndex ) const
+	{
+		assertion( factionIndex >= 0 && factionIndex < GetFactionCount(), "Cannot get Faction %d from GameSnapshot because the index is out of range!", factionIndex );
+		return mFactions[ factionIndex ];
+	}
+
+
+	inline int GameSnapshot::GetFunds( int factionIndex ) const
+	{
+		return mFactions[ factionIndex ].funds;
+	}
+
+
+	inline int GameSnapshot::GetPlayerCount() const
+	{
+		return (int) mPlayerFactionIndices.size();
+	}
+
+
+	inline int GameSnapshot::GetCurrentPlayerIndex() const
+	{
+		return mCurrentPlayerIndex;
+	}
+
+
+	inline int GameSnapshot::GetCurrentFactionIndex() const
+	{
+		return mPlayerFactionIndices[ mCurrentPlayerIndex ];
+	}
+
+
+	inline int GameSnapshot::GetTurnIndex() const
+	{
+		return mTurnIndex;
+	}
+
+
+	inline RandomStream& GameSnapshot::GetRandom()
+	{
+		return mRandom;
+	}
+}
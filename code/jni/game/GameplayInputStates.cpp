@@ -343,6 +343,17 @@ void SelectActionInputState::OnWaitButtonPressed()
 	const Path& path = mapView->GetSelectedUnitPath();
 	unit->Move( path );
 
+	// The Unit is done for this turn.
+	unit->Deactivate();
+
+	Game* game = owner->GetGame();
+
+	if( game->IsInProgress() && !unit->GetOwner()->HasActiveUnits() )
+	{
+		// If none of the user's Units can act any more, end the turn (which lets computer-controlled Players take theirs).
+		game->NextTurn();
+	}
+
 	// Exit the state.
 	owner->ChangeState( owner->GetSelectUnitInputState() );
 }
@@ -40,17 +40,29 @@ void GameplayState::OnEnter( const Dictionary& parameters )
 	bool success = mScenario.LoadDataFromFile( "data/Data.json" );
 	assertion( success, "The Scenario file \"%s\" could not be opened!" );
 
+	// Pre-load all animations used by the Scenario.
+	mScenario.LoadAnimations();
+
 	// Create a new Map and paint it with default tiles.
 	mMap.Init( &mScenario );
 	mMap.Resize( 16, 12 );
 	mMap.FillWithDefaultTerrainType();
 
-	// Create a Faction.
+	// Create a Faction for the user and one for the computer.
 	Faction* testFaction = mMap.CreateFaction();
+	Faction* computerFaction = mMap.CreateFaction();
 
-	// Create a test Unit.
+	// Create test Units.
 	UnitType* testUnitType = mScenario.UnitTypes.FindByName( "Tank" );
 	mMap.CreateUnit( testUnitType, testFaction, 5, 5, 10, 99 );
+	mMap.CreateUnit( testUnitType, computerFaction, 10, 6, 10, 99 );
+
+	// Start a Game between the user and the computer.
+	mGame.Init( &mMap );
+	mGame.CreatePlayer( testFaction );
+	Player* computerPlayer = mGame.CreatePlayer( computerFaction );
+	computerPlayer->SetComputerControlled( true );
+	mGame.Start();
 
 	// Set the default font for the MapView.
 	mMapView.SetDefaultFont( gWidgetManager->GetFontByName( "default_s.fnt" ) );
@@ -90,6 +102,13 @@ void GameplayState::OnEnter( const Dictionary& parameters )
 
 void GameplayState::OnUpdate( float elapsedTime )
 {
+	if( mGame.IsInProgress() && mGame.GetCurrentPlayer()->IsComputerControlled() )
+	{
+		// If it's a computer-controlled Player's turn, let the AIPlanner play it (one turn per frame, so the MapView
+		// shows the results of each turn).
+		mGame.PlayComputerTurn();
+	}
+
 	if( mMapView.IsInitialized() )
 	{
 		// Update the MapView.
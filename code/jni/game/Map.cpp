@@ -1,26 +1,30 @@
-#include "androidwars.h"
+#include "androidwars_sim.h"
 
 using namespace mage;
 
 
 const char* const Map::MAPS_FOLDER_PATH = "map";
 const char* const Map::MAP_FILE_EXTENSION = "maps/";
+const int Map::DEFAULT_MAX_TURN_COUNT;
+const int Map::NO_CONNECTIVITY_LABEL;
+const int Map::UNVISITED_CONNECTIVITY_LABEL;
 
 
 Tile::Tile() :
 	mTerrainType( nullptr ),
-	mBestTotalCostToEnter( 0 ),
-	mLastClosedSearchIndex( -1 ),
-	mLastOpenedSearchIndex( -1 ),
 	mOwner( nullptr ),
-	mUnit( nullptr )
+	mUnit( nullptr ),
+	mMap( nullptr ),
+	mIsChanged( false )
 { }
 
 
 Tile::Tile( const Tile& other ) :
 	mTerrainType( other.mTerrainType ),
 	mOwner( other.mOwner ),
-	OnChanged() // Don't copy event bindings.
+	mUnit( nullptr ),
+	mMap( nullptr ), // Don't copy the Map binding.
+	mIsChanged( false )
 { }
 
 
@@ -43,6 +47,12 @@ void Tile::SetTerrainType( TerrainType* terrainType )
 	// Set the TerrainType.
 	mTerrainType = terrainType;
 
+	if( mOwner && mMap && mTerrainType != oldTerrainType )
+	{
+		// If the tile has an owner, let it update its income for the new TerrainType.
+		mOwner->TileTerrainTypeChanged( oldTerrainType, mTerrainType );
+	}
+
 	if( !IsCapturable() )
 	{
 		// If the tile should not have an owner, clear it.
@@ -51,8 +61,9 @@ void Tile::SetTerrainType( TerrainType* terrainType )
 
 	if( mTerrainType != oldTerrainType )
 	{
-		// If the TerrainType changed, fire the changed callback.
-		OnChanged.Invoke();
+		// If the TerrainType changed, notify the Map.
+		SyncToMap();
+		Changed();
 	}
 }
 
@@ -80,17 +91,20 @@ void Tile::SetOwner( Faction* owner )
 	// Save the old value.
 	Faction* oldOwner = mOwner;
 
-	if( !owner || IsCapturable() )
+	if( ( !owner || IsCapturable() ) && owner != oldOwner )
 	{
 		// Only set the owner if the tile can be captured or the
 		// owner is being cleared.
+		RemoveFromOwner();
 		mOwner = owner;
+		AddToOwner();
 	}
 
 	if( mOwner != oldOwner )
 	{
-		// If the owner changed, fire the changed callback.
-		OnChanged.Invoke();
+		// If the owner changed, notify the Map.
+		SyncToMap();
+		Changed();
 	}
 }
 
@@ -116,6 +130,7 @@ bool Tile::HasOwner() const
 void Tile::SetUnit( Unit* unit )
 {
 	mUnit = unit;
+	SyncToMap();
 }
 
 
@@ -149,51 +164,44 @@ bool Tile::IsCapturable() const
 }
 
 
-void Tile::Open( int searchIndex )
-{
-	mLastOpenedSearchIndex = searchIndex;
-}
-
-
-bool Tile::IsOpen( int searchIndex ) const
-{
-	return ( mLastOpenedSearchIndex == searchIndex );
-}
-
-
-void Tile::Close( int searchIndex )
-{
-	mLastClosedSearchIndex = searchIndex;
-}
-
-
-bool Tile::IsClosed( int searchIndex ) const
+void Tile::AddToOwner()
 {
-	return ( mLastClosedSearchIndex == searchIndex );
-}
-
-
-void Tile::SetPreviousTileDirection( PrimaryDirection direction )
-{
-	mPreviousTileDirection = direction;
+	if( mOwner && mMap )
+	{
+		// Let the owner keep track of its tiles (and the income from them).
+		mOwner->TileGained( mMap->GetTile( mTilePos ) );
+	}
 }
 
 
-PrimaryDirection Tile::GetPreviousTileDirection() const
+void Tile::RemoveFromOwner()
 {
-	return mPreviousTileDirection;
+	if( mOwner && mMap )
+	{
+		// Let the owner keep track of its tiles (and the income from them).
+		mOwner->TileLost( mMap->GetTile( mTilePos ) );
+	}
 }
 
 
-void Tile::SetBestTotalCostToEnter( int totalCostToEnter )
+void Tile::Changed()
 {
-	mBestTotalCostToEnter = totalCostToEnter;
+	if( mMap && !mIsChanged )
+	{
+		// If this Tile belongs to a Map and hasn't already been flagged, add it to the Map's list of changed tiles.
+		mIsChanged = true;
+		mMap->TileChanged( this );
+	}
 }
 
 
-int Tile::GetBestTotalCostToEnter() const
+void Tile::SyncToMap()
 {
-	return mBestTotalCostToEnter;
+	if( mMap )
+	{
+		// If this Tile belongs to a Map, update the Map's dense copy of the Tile data.
+		mMap->SyncTileData( *this );
+	}
 }
 
 
@@ -207,8 +215,9 @@ std::string Map::FormatMapPath( const std::string& mapName )
 
 Map::Map() :
 	mIsInitialized( false ),
+	mRevision( 0 ),
 	mScenario( nullptr ),
-	mNextSearchIndex( 0 )
+	mIsConnectivityUpToDate( false )
 { }
 
 
@@ -229,20 +238,16 @@ void Map::Init( Scenario* scenario )
 	// Make sure the size of the map is valid.
 	assertion( IsValid(), "Cannot initialize Map with invalid size (%d,%d)!", GetWidth(), GetHeight() );
 
-	// Get the default TerrainType for the Scenario.
-	TerrainType* defaultTerrainType = mScenario->GetDefaultTerrainType();
+	// Initialize any tiles that have already been allocated.
+	InitTiles( GetAllocatedBounds() );
 
-	ForEachTileInMaxArea( [ this, defaultTerrainType ]( const Iterator& tile )
-	{
-		// Initialize all tiles to the default TerrainType.
-		tile->SetTerrainType( defaultTerrainType );
+	// Initialize tiles as they are allocated.
+	OnChunkAllocated.AddCallback( this, &Map::InitTiles );
 
-		tile->OnChanged.AddCallback( [ this, tile ]()
-		{
-			// When the Tile changes, notify the Map that the Tile has changed.
-			TileChanged( tile );
-		});
-	});
+	// Build the dense tile data and keep it up to date as the Map is resized.
+	mPathHierarchy.Init( this );
+	RebuildTileData();
+	OnResize.AddCallback( this, &Map::Resized );
 }
 
 
@@ -250,6 +255,22 @@ void Map::Destroy()
 {
 	assertion( mIsInitialized, "Cannot destroy Map that has not been initialized!" );
 
+	// Stop initializing newly allocated tiles.
+	OnChunkAllocated.RemoveCallback( this, &Map::InitTiles );
+	OnResize.RemoveCallback( this, &Map::Resized );
+
+	for( auto it = mChangedTiles.begin(); it != mChangedTiles.end(); ++it )
+	{
+		// Forget about any pending tile changes.
+		GetTile( *it )->mIsChanged = false;
+	}
+
+	mChangedTiles.clear();
+
+	// Throw away the connectivity data.
+	InvalidateConnectivity();
+	mPathHierarchy.Destroy();
+
 	// Clear the scenario.
 	mScenario = nullptr;
 
@@ -344,6 +365,10 @@ void Map::FillWithDefaultTerrainType()
 	TerrainType* defaultTerrainType = mScenario->GetDefaultTerrainType();
 	assertion( defaultTerrainType != nullptr, "No default TerrainType found for this Scenario!" );
 
+	// Rebuild the connectivity data from scratch afterwards instead of updating it for every tile.
+	InvalidateConnectivity();
+	mPathHierarchy.Invalidate();
+
 	// Fill the whole Map with the default TerrainType.
 	Tile tile;
 	tile.SetTerrainType( defaultTerrainType );
@@ -414,7 +439,7 @@ void Map::DestroyFaction( Faction* faction )
 
 Unit* Map::CreateUnit( UnitType* unitType, Faction* owner, short tileX, short tileY, int health, int ammo, int supplies )
 {
-	return CreateUnit( unitType, owner, Vec2s( tileX, tileY ) );
+	return CreateUnit( unitType, owner, Vec2s( tileX, tileY ), health, ammo, supplies );
 }
 
 
@@ -494,74 +519,141 @@ void Map::ForEachUnit( ForEachConstUnitCallback callback ) const
 
 
 
-void Map::FindReachableTiles( const Unit* unit, TileSet& result )
+const TileIndexSet& Map::FindReachableTiles( const Unit* unit )
 {
-	int searchIndex = ReserveSearchIndex();
+	// Search the Map using a dedicated search context, so later path queries for the Unit can reuse the results.
+	FindReachableTiles( unit, mReachableTilesContext );
+	return mReachableTilesContext.GetReachedTiles();
+}
 
-	// Clear the list of results.
-	result.clear();
 
-	// Clear the open list.
-	mOpenList.clear();
+void Map::FindReachableTiles( const Unit* unit, SearchContext& context ) const
+{
+	assertion( unit, "Cannot find reachable tiles for null Unit!" );
 
-	// Get the Unit's current Tile and type.
-	Iterator originTile = unit->GetTile();
-	UnitType* unitType = unit->GetUnitType();
-	MovementType* movementType = unit->GetMovementType();
+	// Search from the Unit's tile.
+	SearchSources sources( 1 );
+	sources[ 0 ].tilePos = unit->GetTilePos();
+	sources[ 0 ].movementRange = unit->GetMovementRange();
+	FindReachableTilesFromSources( unit->GetMovementType(), sources, context, unit->GetOwner() );
 
-	// Get the starting movement range of the Unit.
-	int movementRange = unit->GetMovementRange();
+	// Remember the state the search was run with.
+	context.SetSource( unit, sources[ 0 ].tilePos, sources[ 0 ].movementRange, mRevision );
+}
 
-	// Add the origin tile to the open list.
-	originTile->Open( searchIndex );
-	originTile->SetPreviousTileDirection( PrimaryDirection::NONE );
-	originTile->SetBestTotalCostToEnter( 0 );
-	mOpenList.insert( 0, originTile );
 
-	while( !mOpenList.isEmpty() )
+void Map::FindReachableTilesFromSources( const MovementType* movementType, const SearchSources& sources, SearchContext& context, const Faction* faction ) const
+{
+	// Start a new search.
+	context.BeginSearch( (size_t) GetWidth() * (size_t) GetHeight() );
+	SearchContext::OpenList& openList = context.GetOpenList();
+
+	if( faction )
+	{
+		// If the search is for a Faction, mark the tiles its Units can't stop on or pass through.
+		BuildOccupancy( faction, context );
+	}
+
+	// Get the movement costs for the MovementType, indexed by TerrainType ID.
+	const int* movementCosts = mScenario->GetMovementCostsByTerrainTypeID( movementType );
+
+	// Find the longest movement range of all sources.
+	int movementRange = 0;
+
+	for( auto it = sources.begin(); it != sources.end(); ++it )
+	{
+		movementRange = std::max( movementRange, it->movementRange );
+	}
+
+	for( auto it = sources.begin(); it != sources.end(); ++it )
+	{
+		// Sources with shorter movement ranges start with the difference already spent, so every source can share one search.
+		int initialCost = ( movementRange - it->movementRange );
+		size_t originIndex = GetCompactTileIndex( it->tilePos );
+
+		// Each source is the tile of a Unit that is searching, so it can always stay where it is.
+		context.SetTileOccupancy( originIndex, SearchContext::OCCUPANCY_NONE );
+
+		if( !openList.hasIndex( originIndex ) )
+		{
+			// Add the origin tile to the open list.
+			context.SetPreviousTileDirection( originIndex, PrimaryDirection::NONE );
+			context.SetBestTotalCostToEnter( originIndex, initialCost );
+			openList.insert( ( initialCost << 1 ), originIndex );
+		}
+		else if( initialCost < context.GetBestTotalCostToEnter( originIndex ) )
+		{
+			// If another source shares the tile, keep the one with the longest movement range.
+			context.SetBestTotalCostToEnter( originIndex, initialCost );
+			openList.update( ( initialCost << 1 ), originIndex );
+		}
+	}
+
+	while( !openList.isEmpty() )
 	{
 		// Pop the first element off the open list.
-		Map::Iterator tile = mOpenList.popMinElement();
+		size_t tileIndex = openList.popMinIndex();
+		Vec2s tilePos = GetTilePosFromCompactIndex( tileIndex );
 
-		// Close the tile and add it to the result.
-		tile->Close( searchIndex );
-		result.insert( tile );
+		// Close the tile.
+		context.Close( tileIndex );
+
+		if( context.GetTileOccupancy( tileIndex ) == SearchContext::OCCUPANCY_NONE )
+		{
+			// If no other Unit is on the tile, add it to the result (friendly Units can be passed through but not stopped on).
+			context.AddReachedTile( tileIndex );
+		}
+
+		// Get the direction the search entered this tile from (used to favor straight paths).
+		PrimaryDirection previousDirection = context.GetPreviousTileDirection( tileIndex );
 
 		for( int i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
 		{
 			// Determine the direction to search.
 			PrimaryDirection direction = CARDINAL_DIRECTIONS[ i ];
 
-			// If the adjacent tile isn't in the previous direction, get the adjacent tile.
-			Iterator adjacent = tile.GetAdjacent( direction );
+			// Get the adjacent tile.
+			Vec2s adjacentPos = ( tilePos + direction.GetOffset() );
 
-			if( adjacent.IsValid() && !adjacent->IsClosed( searchIndex ) )
+			if( !IsValidTilePos( adjacentPos ) )
 			{
-				// If the adjacent tile is valid and isn't already closed, get the TerrainType of the adjacent tile.
-				TerrainType* adjacentTerrainType = adjacent->GetTerrainType();
+				continue;
+			}
+
+			size_t adjacentIndex = GetCompactTileIndex( adjacentPos );
+			short adjacentTerrainTypeID = mTerrainTypeIDs[ adjacentIndex ];
 
-				if( movementType->CanMoveAcrossTerrain( adjacentTerrainType ) )
+			if( !context.IsClosed( adjacentIndex ) && adjacentTerrainTypeID > -1 &&
+				context.GetTileOccupancy( adjacentIndex ) != SearchContext::OCCUPANCY_ENEMY )
+			{
+				// If the adjacent tile is valid and isn't already closed, get the cost of entering the adjacent tile.
+				int costToEnterAdjacent = movementCosts[ adjacentTerrainTypeID ];
+
+				if( costToEnterAdjacent > -1 )
 				{
 					// If the adjacent tile is passable, find the total cost of entering the tile.
-					int costToEnterAdjacent = movementType->GetMovementCostAcrossTerrain( adjacentTerrainType );
-					int adjacentTotalCost = ( tile->GetBestTotalCostToEnter() + costToEnterAdjacent );
+					int adjacentTotalCost = ( context.GetBestTotalCostToEnter( tileIndex ) + costToEnterAdjacent );
+
+					// Break ties between tiles with the same total cost in favor of not turning.
+					bool isTurn = ( previousDirection != PrimaryDirection::NONE && direction != previousDirection.GetOppositeDirection() );
+					int adjacentWeight = ( ( adjacentTotalCost << 1 ) + ( isTurn ? 1 : 0 ) );
 
 					if( adjacentTotalCost <= movementRange )
 					{
-						if( !adjacent->IsOpen( searchIndex ) )
+						if( !openList.hasIndex( adjacentIndex ) )
 						{
 							// If the tile info isn't already on the open list, add it.
-							adjacent->SetPreviousTileDirection( direction.GetOppositeDirection() );
-							adjacent->SetBestTotalCostToEnter( adjacentTotalCost );
-							mOpenList.insert( adjacentTotalCost, adjacent );
+							context.SetPreviousTileDirection( adjacentIndex, direction.GetOppositeDirection() );
+							context.SetBestTotalCostToEnter( adjacentIndex, adjacentTotalCost );
+							openList.insert( adjacentWeight, adjacentIndex );
 						}
-						else if( adjacentTotalCost < adjacent->GetBestTotalCostToEnter() )
+						else if( adjacentTotalCost < context.GetBestTotalCostToEnter( adjacentIndex ) )
 						{
 							// If the node is already on the open list but has a larger total cost,
 							// update the value.
-							adjacent->SetPreviousTileDirection( direction.GetOppositeDirection() );
-							adjacent->SetBestTotalCostToEnter( adjacentTotalCost );
-							mOpenList.update( adjacentTotalCost, adjacent );
+							context.SetPreviousTileDirection( adjacentIndex, direction.GetOppositeDirection() );
+							context.SetBestTotalCostToEnter( adjacentIndex, adjacentTotalCost );
+							openList.update( adjacentWeight, adjacentIndex );
 						}
 					}
 				}
@@ -577,90 +669,148 @@ void Map::ForEachReachableTile( const Unit* unit, ForEachReachableTileCallback c
 	assertion( callback.IsValid(), "Cannot call invalid callback on reachable tiles!" );
 
 	// Find all reachable tiles for the Unit.
-	TileSet reachableTiles;
-	FindReachableTiles( unit, reachableTiles );
+	const TileIndexSet& reachableTiles = FindReachableTiles( unit );
 
 	for( auto it = reachableTiles.begin(); it != reachableTiles.end(); ++it )
 	{
 		// Invoke the callback on all reachable tiles.
-		callback.Invoke( *it, unit );
+		callback.Invoke( GetTile( GetTilePosFromCompactIndex( *it ) ), unit );
 	}
 }
 
 
 void Map::FindBestPathToTile( const Unit* unit, const Vec2s& tilePos, Path& result )
 {
+	// Make sure unreachable tiles can be rejected without searching.
+	UpdateConnectivity();
+
+	if( IsSearchCurrent( mReachableTilesContext, unit ) )
+	{
+		// If the reachable tiles for the Unit are still up to date, build the path from them without searching again.
+		BuildPathFromSearch( mReachableTilesContext, tilePos, result );
+	}
+	else
+	{
+		// Otherwise, search the Map using the main thread's search context.
+		FindBestPathToTile( unit, tilePos, result, mSearchContext );
+	}
+}
+
+
+bool Map::FindBestPathToTile( const Unit* unit, const Vec2s& tilePos, Path& result, SearchContext& context ) const
+{
+	assertion( unit, "Cannot find path for null Unit!" );
+
 	std::vector< PrimaryDirection > reverseDirections;
-	int searchIndex = ReserveSearchIndex();
+	bool foundPath = false;
 
 	// Clear the list of results.
 	result.Clear();
 	result.SetOrigin( unit->GetTilePos() );
 
-	// Clear the open list.
-	mOpenList.clear();
+	// Start a new search.
+	context.BeginSearch( (size_t) GetWidth() * (size_t) GetHeight() );
+	SearchContext::OpenList& openList = context.GetOpenList();
 
-	// Get the Unit's current Tile and type.
-	Iterator originTile = unit->GetTile();
-	UnitType* unitType = unit->GetUnitType();
+	// Get the Unit's movement type.
+	Vec2s originPos = unit->GetTilePos();
 	MovementType* movementType = unit->GetMovementType();
 
+	// Get the movement costs for the Unit, indexed by TerrainType ID.
+	const int* movementCosts = mScenario->GetMovementCostsByTerrainTypeID( movementType );
+
 	// Get the starting movement range of the Unit.
 	int movementRange = unit->GetMovementRange();
 
+	// Scale the distance heuristic by the cheapest tile the Unit can enter so it never overestimates the cost to the goal.
+	int minimumMovementCost = mScenario->GetMinimumMovementCost( movementType );
+
+	if( !IsValidTilePos( tilePos ) || ( originPos.GetManhattanDistanceTo( tilePos ) * minimumMovementCost ) > movementRange ||
+		!AreTilesConnected( movementType, originPos, tilePos ) )
+	{
+		// If the goal can't possibly be reached, don't search.
+		return false;
+	}
+
+	// Mark the tiles the Unit can't stop on or pass through.
+	size_t originIndex = GetCompactTileIndex( originPos );
+	BuildOccupancy( unit->GetOwner(), context );
+	context.SetTileOccupancy( originIndex, SearchContext::OCCUPANCY_NONE );
+
+	if( context.GetTileOccupancy( GetCompactTileIndex( tilePos ) ) != SearchContext::OCCUPANCY_NONE )
+	{
+		// If another Unit is standing on the goal, the Unit can't end its move there.
+		return false;
+	}
+
 	// Add the origin tile to the open list.
-	originTile->Open( searchIndex );
-	originTile->SetPreviousTileDirection( PrimaryDirection::NONE );
-	originTile->SetBestTotalCostToEnter( 0 );
-	mOpenList.insert( 0, originTile );
+	context.SetPreviousTileDirection( originIndex, PrimaryDirection::NONE );
+	context.SetBestTotalCostToEnter( originIndex, 0 );
+	openList.insert( 0, originIndex );
 
-	while( !mOpenList.isEmpty() )
+	while( !openList.isEmpty() )
 	{
 		// Pop the first element off the open list.
-		Map::Iterator tile = mOpenList.popMinElement();
+		size_t tileIndex = openList.popMinIndex();
+		Vec2s currentPos = GetTilePosFromCompactIndex( tileIndex );
 
-		if( tile.GetPosition() != tilePos )
+		if( currentPos != tilePos )
 		{
 			// If this isn't the goal tile, close it.
-			tile->Close( searchIndex );
+			context.Close( tileIndex );
+
+			// Get the direction the search entered this tile from (used to favor straight paths).
+			PrimaryDirection previousDirection = context.GetPreviousTileDirection( tileIndex );
 
 			for( int i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
 			{
 				// Determine the direction to search.
 				PrimaryDirection direction = CARDINAL_DIRECTIONS[ i ];
 
-				// If the adjacent tile isn't in the previous direction, get the adjacent tile.
-				Iterator adjacent = tile.GetAdjacent( direction );
+				// Get the adjacent tile.
+				Vec2s adjacentPos = ( currentPos + direction.GetOffset() );
 
-				if( adjacent.IsValid() && !adjacent->IsClosed( searchIndex ) )
+				if( !IsValidTilePos( adjacentPos ) )
 				{
-					// If the adjacent tile is valid and isn't already closed, get the TerrainType of the adjacent tile.
-					TerrainType* adjacentTerrainType = adjacent->GetTerrainType();
+					continue;
+				}
+
+				size_t adjacentIndex = GetCompactTileIndex( adjacentPos );
+				short adjacentTerrainTypeID = mTerrainTypeIDs[ adjacentIndex ];
+
+				if( !context.IsClosed( adjacentIndex ) && adjacentTerrainTypeID > -1 &&
+					context.GetTileOccupancy( adjacentIndex ) != SearchContext::OCCUPANCY_ENEMY )
+				{
+					// If the adjacent tile is valid and isn't already closed, get the cost of entering the adjacent tile.
+					int costToEnterAdjacent = movementCosts[ adjacentTerrainTypeID ];
 
-					if( movementType->CanMoveAcrossTerrain( adjacentTerrainType ) )
+					if( costToEnterAdjacent > -1 )
 					{
 						// If the adjacent tile is passable, find the total cost of entering the tile.
-						int costToEnterAdjacent = movementType->GetMovementCostAcrossTerrain( adjacentTerrainType );
-						int adjacentTotalCost = ( tile->GetBestTotalCostToEnter() + costToEnterAdjacent );
-						int distanceToGoal = ( originTile.GetPosition().GetManhattanDistanceTo( tilePos ) );
-						int adjacentWeight = ( adjacentTotalCost + distanceToGoal );
+						int adjacentTotalCost = ( context.GetBestTotalCostToEnter( tileIndex ) + costToEnterAdjacent );
+						int estimatedCostToGoal = ( adjacentPos.GetManhattanDistanceTo( tilePos ) * minimumMovementCost );
 
-						if( adjacentTotalCost <= movementRange )
+						// Break ties between tiles with the same estimated total cost in favor of not turning.
+						bool isTurn = ( previousDirection != PrimaryDirection::NONE && direction != previousDirection.GetOppositeDirection() );
+						int adjacentWeight = ( ( ( adjacentTotalCost + estimatedCostToGoal ) << 1 ) + ( isTurn ? 1 : 0 ) );
+
+						// Skip the adjacent tile if the goal can't be reached from it within the Unit's movement range.
+						if( adjacentTotalCost + estimatedCostToGoal <= movementRange )
 						{
-							if( !adjacent->IsOpen( searchIndex ) )
+							if( !openList.hasIndex( adjacentIndex ) )
 							{
 								// If the tile info isn't already on the open list, add it.
-								adjacent->SetPreviousTileDirection( direction.GetOppositeDirection() );
-								adjacent->SetBestTotalCostToEnter( adjacentTotalCost );
-								mOpenList.insert( adjacentWeight, adjacent );
+								context.SetPreviousTileDirection( adjacentIndex, direction.GetOppositeDirection() );
+								context.SetBestTotalCostToEnter( adjacentIndex, adjacentTotalCost );
+								openList.insert( adjacentWeight, adjacentIndex );
 							}
-							else if( adjacentTotalCost < adjacent->GetBestTotalCostToEnter() )
+							else if( adjacentTotalCost < context.GetBestTotalCostToEnter( adjacentIndex ) )
 							{
 								// If the node is already on the open list but has a larger total cost,
 								// update the value.
-								adjacent->SetPreviousTileDirection( direction.GetOppositeDirection() );
-								adjacent->SetBestTotalCostToEnter( adjacentTotalCost );
-								mOpenList.update( adjacentWeight, adjacent );
+								context.SetPreviousTileDirection( adjacentIndex, direction.GetOppositeDirection() );
+								context.SetBestTotalCostToEnter( adjacentIndex, adjacentTotalCost );
+								openList.update( adjacentWeight, adjacentIndex );
 							}
 						}
 					}
@@ -670,17 +820,18 @@ void Map::FindBestPathToTile( const Unit* unit, const Vec2s& tilePos, Path& resu
 		else
 		{
 			// If this is the goal tile, construct the path to the location.
-			PrimaryDirection previousDirection = tile->GetPreviousTileDirection();
+			PrimaryDirection previousDirection = context.GetPreviousTileDirection( tileIndex );
 
 			while( previousDirection != PrimaryDirection::NONE )
 			{
 				// Construct the list of directions from the goal back to the origin tile.
 				reverseDirections.push_back( previousDirection );
-				tile = tile.GetAdjacent( previousDirection );
-				previousDirection = tile->GetPreviousTileDirection();
+				currentPos += previousDirection.GetOffset();
+				previousDirection = context.GetPreviousTileDirection( GetCompactTileIndex( currentPos ) );
 			}
 
 			// End the search.
+			foundPath = true;
 			break;
 		}
 	}
@@ -691,6 +842,357 @@ void Map::FindBestPathToTile( const Unit* unit, const Vec2s& tilePos, Path& resu
 		PrimaryDirection direction = *it;
 		result.AddDirection( direction.GetOppositeDirection() );
 	}
+
+	return foundPath;
+}
+
+
+bool Map::FindHierarchicalPath( const MovementType* movementType, const Vec2s& originPos, const Vec2s& goalPos, Path& result )
+{
+	// Reject goals the MovementType can never reach without searching.
+	UpdateConnectivity();
+
+	if( IsValidTilePos( goalPos ) && !AreTilesConnected( movementType, originPos, goalPos ) )
+	{
+		result.Clear();
+		result.SetOrigin( originPos );
+		return false;
+	}
+
+	// Find the path using the cluster graph.
+	return mPathHierarchy.FindPath( movementType, originPos, goalPos, result );
+}
+
+
+bool Map::FindMultiTurnPath( const Unit* unit, const Vec2s& tilePos, Path& result, int maxTurnCount )
+{
+	// Make sure unreachable tiles can be rejected without searching.
+	UpdateConnectivity();
+
+	// Search the Map using the main thread's search context.
+	return FindMultiTurnPath( unit, tilePos, result, mSearchContext, maxTurnCount );
+}
+
+
+bool Map::FindMultiTurnPath( const Unit* unit, const Vec2s& tilePos, Path& result, SearchContext& context, int maxTurnCount ) const
+{
+	assertion( unit, "Cannot find path for null Unit!" );
+	assertion( maxTurnCount > 0, "Cannot find path over %d turns!", maxTurnCount );
+
+	bool foundPath = false;
+
+	// Clear the list of results.
+	result.Clear();
+	result.SetOrigin( unit->GetTilePos() );
+
+	// Get the Unit's movement type.
+	Vec2s originPos = unit->GetTilePos();
+	MovementType* movementType = unit->GetMovementType();
+
+	if( !IsValidTilePos( tilePos ) || !AreTilesConnected( movementType, originPos, tilePos ) )
+	{
+		// If the goal can't possibly be reached, don't search.
+		return false;
+	}
+
+	// Each search node is a tile paired with the turn it is entered on (node index = turn * tile count + tile index),
+	// so that a tile the Unit can pass through but not stop on keeps a separate entry for every turn.
+	size_t tileCount = ( (size_t) GetWidth() * (size_t) GetHeight() );
+
+	// Start a new search.
+	context.BeginSearch( tileCount * (size_t) maxTurnCount );
+	SearchContext::OpenList& openList = context.GetOpenList();
+
+	// Mark the tiles the Unit can't stop on or pass through.
+	size_t originIndex = GetCompactTileIndex( originPos );
+	size_t goalIndex = GetCompactTileIndex( tilePos );
+	size_t goalNodeIndex = 0;
+	BuildOccupancy( unit->GetOwner(), context );
+	context.SetTileOccupancy( originIndex, SearchContext::OCCUPANCY_NONE );
+
+	if( context.GetTileOccupancy( goalIndex ) != SearchContext::OCCUPANCY_NONE )
+	{
+		// If another Unit is standing on the goal, the Unit can't end its move there.
+		return false;
+	}
+
+	// Get the movement costs for the Unit, indexed by TerrainType ID.
+	const int* movementCosts = mScenario->GetMovementCostsByTerrainTypeID( movementType );
+
+	// Each node is keyed by the number of turns needed to reach it, then by the movement spent during the last turn.
+	int maxMovementRange = unit->GetUnitType()->GetMovementRange();
+	int turnStride = ( maxMovementRange + 1 );
+	int suppliesConsumedPerTurn = movementType->GetSuppliesConsumedPerTurn();
+
+	// Add the origin tile to the open list.
+	context.SetPreviousTileDirection( originIndex, PrimaryDirection::NONE );
+	context.SetBestTotalCostToEnter( originIndex, 0 );
+	context.SetRemainingSupplies( originIndex, unit->GetSupplies() );
+	openList.insert( 0, originIndex );
+
+	while( !openList.isEmpty() )
+	{
+		// Pop the first element off the open list.
+		size_t nodeIndex = openList.popMinIndex();
+		size_t tileIndex = ( nodeIndex % tileCount );
+		context.Close( nodeIndex );
+
+		if( tileIndex == goalIndex )
+		{
+			// If this is the goal tile, stop searching.
+			goalNodeIndex = nodeIndex;
+			foundPath = true;
+			break;
+		}
+
+		Vec2s currentPos = GetTilePosFromCompactIndex( tileIndex );
+		int key = context.GetBestTotalCostToEnter( nodeIndex );
+		int turnIndex = ( key / turnStride );
+		int costThisTurn = ( key % turnStride );
+		int remainingSupplies = context.GetRemainingSupplies( nodeIndex );
+
+		// The Unit can move as far as its supplies at the start of the turn allow.
+		int movementRangeThisTurn = std::min( maxMovementRange, remainingSupplies + costThisTurn );
+
+		// Determine whether the Unit could end its turn on this tile (it can't share a tile with another Unit).
+		bool canEndTurnHere = ( context.GetTileOccupancy( tileIndex ) == SearchContext::OCCUPANCY_NONE && turnIndex + 1 < maxTurnCount );
+
+		// Determine how many supplies the Unit would have at the start of the next turn.
+		int nextTurnSupplies = ( remainingSupplies - suppliesConsumedPerTurn );
+		int nextTurnMovementRange = std::min( maxMovementRange, nextTurnSupplies );
+
+		if( movementType->RequiresSuppliesToSurvive() && nextTurnSupplies <= 0 )
+		{
+			// If the Unit would run out of supplies and die at the start of the next turn, it can't end its turn here.
+			canEndTurnHere = false;
+		}
+
+		for( size_t i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
+		{
+			// Determine the direction to search.
+			PrimaryDirection direction = CARDINAL_DIRECTIONS[ i ];
+
+			// Get the adjacent tile.
+			Vec2s adjacentPos = ( currentPos + direction.GetOffset() );
+
+			if( !IsValidTilePos( adjacentPos ) )
+			{
+				continue;
+			}
+
+			size_t adjacentIndex = GetCompactTileIndex( adjacentPos );
+			short adjacentTerrainTypeID = mTerrainTypeIDs[ adjacentIndex ];
+			SearchContext::TileOccupancy adjacentOccupancy = context.GetTileOccupancy( adjacentIndex );
+
+			if( adjacentTerrainTypeID < 0 || adjacentOccupancy == SearchContext::OCCUPANCY_ENEMY )
+			{
+				// Skip invalid tiles and tiles blocked by enemy Units.
+				continue;
+			}
+
+			int costToEnterAdjacent = movementCosts[ adjacentTerrainTypeID ];
+
+			if( costToEnterAdjacent < 0 )
+			{
+				// Skip impassable tiles.
+				continue;
+			}
+
+			bool canEnterThisTurn = ( costThisTurn + costToEnterAdjacent <= movementRangeThisTurn );
+			bool isAdjacentFriendly = ( adjacentOccupancy == SearchContext::OCCUPANCY_FRIENDLY );
+
+			if( canEnterThisTurn )
+			{
+				// If the Unit can enter the tile during the current turn, keep moving.
+				RelaxMultiTurnNode( context, adjacentIndex, tileCount, turnIndex, direction.GetOppositeDirection(),
+					key + costToEnterAdjacent, remainingSupplies - costToEnterAdjacent, isAdjacentFriendly );
+			}
+
+			if( canEndTurnHere && costToEnterAdjacent <= nextTurnMovementRange && ( !canEnterThisTurn || isAdjacentFriendly ) )
+			{
+				// Otherwise, end the turn here and enter the tile at the start of the next turn. A friendly Unit's tile can't
+				// be stopped on, so entering it at the start of a turn can lead further than entering it at the end of one.
+				RelaxMultiTurnNode( context, adjacentIndex, tileCount, turnIndex + 1, direction.GetOppositeDirection(),
+					( turnIndex + 1 ) * turnStride + costToEnterAdjacent, nextTurnSupplies - costToEnterAdjacent, isAdjacentFriendly );
+			}
+		}
+	}
+
+	if( foundPath )
+	{
+		// Collect the directions and turn indices from the goal back to the origin tile.
+		std::vector< PrimaryDirection > reverseDirections;
+		std::vector< int > reverseTurnIndices;
+		Vec2s currentPos = tilePos;
+		size_t currentNodeIndex = goalNodeIndex;
+		PrimaryDirection previousDirection = context.GetPreviousTileDirection( currentNodeIndex );
+
+		while( previousDirection != PrimaryDirection::NONE )
+		{
+			int turnIndex = (int) ( currentNodeIndex / tileCount );
+			int costThisTurn = ( context.GetBestTotalCostToEnter( currentNodeIndex ) % turnStride );
+			int costToEnter = movementCosts[ mTerrainTypeIDs[ currentNodeIndex % tileCount ] ];
+
+			reverseDirections.push_back( previousDirection );
+			reverseTurnIndices.push_back( turnIndex );
+			currentPos += previousDirection.GetOffset();
+
+			// Every move costs something, so only a tile entered at the start of a turn has spent exactly its own cost
+			// that turn. Its previous tile is where the last turn ended.
+			int previousTurnIndex = ( ( turnIndex > 0 && costThisTurn == costToEnter ) ? turnIndex - 1 : turnIndex );
+			currentNodeIndex = ( (size_t) previousTurnIndex * tileCount + GetCompactTileIndex( currentPos ) );
+			previousDirection = context.GetPreviousTileDirection( currentNodeIndex );
+		}
+
+		int turnIndex = 0;
+
+		for( size_t i = reverseDirections.size(); i > 0; --i )
+		{
+			if( reverseTurnIndices[ i - 1 ] > turnIndex )
+			{
+				// If the next tile is entered on a later turn, end the current turn before moving.
+				result.EndTurn();
+				turnIndex = reverseTurnIndices[ i - 1 ];
+			}
+
+			// Construct the path by reversing the directions from the goal to the origin.
+			PrimaryDirection direction = reverseDirections[ i - 1 ];
+			result.AddDirection( direction.GetOppositeDirection() );
+		}
+	}
+
+	return foundPath;
+}
+
+
+void Map::FindAttackOptions( const Faction* faction, AttackOptions& result )
+{
+	// Search the Map using the main thread's search context.
+	FindAttackOptions( faction, result, mSearchContext );
+}
+
+
+void Map::FindAttackOptions( const Faction* faction, AttackOptions& result, SearchContext& context ) const
+{
+	// Clear the list of results.
+	result.clear();
+
+	// Gather all potential targets along with their defense bonuses.
+	std::vector< std::pair< const Unit*, float > > targets;
+
+	for( auto it = mUnits.begin(); it != mUnits.end(); ++it )
+	{
+		const Unit* target = *it;
+
+		if( target->IsAlive() && target->GetOwner() != faction )
+		{
+			// The target's defense doesn't depend on the attacker, so only calculate it once.
+			targets.push_back( std::make_pair( target, target->GetDefenseBonus() ) );
+		}
+	}
+
+	for( auto attackerIt = mUnits.begin(); attackerIt != mUnits.end() && !targets.empty(); ++attackerIt )
+	{
+		const Unit* attacker = *attackerIt;
+		const UnitType* attackerType = attacker->GetUnitType();
+
+		if( !attacker->IsAlive() || attacker->GetOwner() != faction || attackerType->GetNumWeapons() == 0 )
+		{
+			// Skip Units that can't attack for this Faction.
+			continue;
+		}
+
+		// Find all tiles the attacker can attack from.
+		FindReachableTiles( attacker, context );
+		const TileIndexSet& reachableTiles = context.GetReachedTiles();
+
+		const IntRange& attackRange = attackerType->GetAttackRange();
+
+		for( auto targetIt = targets.begin(); targetIt != targets.end(); ++targetIt )
+		{
+			const Unit* target = targetIt->first;
+			const UnitType* targetType = target->GetUnitType();
+
+			// Choose the most damaging weapon that can currently fire at the target.
+			int bestWeaponIndex = Unit::ChooseBestWeaponAgainst( mScenario, attackerType, attacker->GetAmmo(), targetType );
+
+			if( bestWeaponIndex < 0 )
+			{
+				// If no weapon can hit the target, skip it.
+				continue;
+			}
+
+			// Calculate the damage before randomness.
+			int baseDamagePercentage = mScenario->GetDamagePercentage( attackerType, bestWeaponIndex, targetType );
+			int damagePercentage = Unit::ScaleDamagePercentage( baseDamagePercentage, attacker->GetHealth(), targetIt->second );
+			Vec2s targetPos = target->GetTilePos();
+
+			for( int dy = -attackRange.Max; dy <= attackRange.Max; ++dy )
+			{
+				int remainingRange = ( attackRange.Max - std::abs( dy ) );
+
+				for( int dx = -remainingRange; dx <= remainingRange; ++dx )
+				{
+					Vec2s tilePos( (short) ( targetPos.x + dx ), (short) ( targetPos.y + dy ) );
+
+					if( std::abs( dx ) + std::abs( dy ) >= attackRange.Min && IsValidTilePos( tilePos ) &&
+						reachableTiles.Contains( GetCompactTileIndex( tilePos ) ) )
+					{
+						// If the attacker can move to a tile in range of the target, add the attack to the results.
+						AttackOption option;
+						option.attacker = attacker;
+						option.target = target;
+						option.tilePos = tilePos;
+						option.weaponIndex = bestWeaponIndex;
+						option.damagePercentage = damagePercentage;
+						result.push_back( option );
+					}
+				}
+			}
+		}
+	}
+}
+
+
+bool Map::IsSearchCurrent( const SearchContext& context, const Unit* unit ) const
+{
+	// Check whether the search was run for the Unit in its current state and nothing on the Map has changed since.
+	return context.IsFromSource( unit, unit->GetTilePos(), unit->GetMovementRange(), mRevision );
+}
+
+
+bool Map::BuildPathFromSearch( const SearchContext& context, const Vec2s& tilePos, Path& result ) const
+{
+	// Clear the list of results.
+	result.Clear();
+	result.SetOrigin( context.GetOriginPos() );
+
+	if( !IsValidTilePos( tilePos ) || !context.GetReachedTiles().Contains( GetCompactTileIndex( tilePos ) ) )
+	{
+		// If the tile wasn't reached by the search, there is no path to it.
+		return false;
+	}
+
+	std::vector< PrimaryDirection > reverseDirections;
+	Vec2s currentPos = tilePos;
+	PrimaryDirection previousDirection = context.GetPreviousTileDirection( GetCompactTileIndex( currentPos ) );
+
+	while( previousDirection != PrimaryDirection::NONE )
+	{
+		// Construct the list of directions from the goal back to the origin tile.
+		reverseDirections.push_back( previousDirection );
+		currentPos += previousDirection.GetOffset();
+		previousDirection = context.GetPreviousTileDirection( GetCompactTileIndex( currentPos ) );
+	}
+
+	for( auto it = reverseDirections.rbegin(); it != reverseDirections.rend(); ++it )
+	{
+		// Construct the path by reversing the directions from the goal to the origin.
+		PrimaryDirection direction = *it;
+		result.AddDirection( direction.GetOppositeDirection() );
+	}
+
+	return true;
 }
 
 
@@ -724,16 +1226,389 @@ Scenario* Map::GetScenario() const
 }
 
 
-int Map::ReserveSearchIndex()
+void Map::InitTiles( const RectS& area )
+{
+	// Get the default TerrainType for the Scenario.
+	TerrainType* defaultTerrainType = mScenario->GetDefaultTerrainType();
+
+	ForEachTileInArea( area, [ this, defaultTerrainType ]( const Iterator& tile )
+	{
+		// Initialize all tiles to the default TerrainType.
+		tile->SetTerrainType( defaultTerrainType );
+
+		// Bind the Tile to the Map so it can report changes.
+		tile->mMap = this;
+		tile->mTilePos = tile.GetPosition();
+	});
+}
+
+
+void Map::Resized( const Vec2s& oldSize, const Vec2s& newSize )
+{
+	// Lay out the dense tile data for the new size.
+	RebuildTileData();
+}
+
+
+void Map::RebuildTileData()
+{
+	size_t tileCount = ( (size_t) GetWidth() * (size_t) GetHeight() );
+
+	// Invalidate any previous search results.
+	++mRevision;
+	InvalidateConnectivity();
+	mPathHierarchy.Invalidate();
+
+	// Resize the dense tile data.
+	mTerrainTypeIDs.resize( tileCount );
+	mTileOwners.resize( tileCount );
+	mTileUnits.resize( tileCount );
+
+	ForEachTile( [ this ]( const Iterator& tile )
+	{
+		// Copy the data for each Tile.
+		SyncTileData( *tile );
+	});
+}
+
+
+void Map::SyncTileData( const Tile& tile )
 {
-	return mNextSearchIndex++;
+	if( IsValidTilePos( tile.mTilePos ) )
+	{
+		// If the Tile is within the bounds of the Map, copy its data into the dense arrays.
+		size_t index = GetCompactTileIndex( tile.mTilePos );
+		short oldTerrainTypeID = mTerrainTypeIDs[ index ];
+		mTerrainTypeIDs[ index ] = (short) ( tile.mTerrainType ? tile.mTerrainType->GetID() : -1 );
+		mTileOwners[ index ] = tile.mOwner;
+		mTileUnits[ index ] = tile.mUnit;
+
+		// Invalidate any previous search results.
+		++mRevision;
+
+		if( mTerrainTypeIDs[ index ] != oldTerrainTypeID )
+		{
+			if( mIsConnectivityUpToDate )
+			{
+				// If the TerrainType changed, update the connectivity data around the tile.
+				UpdateConnectivityAroundTile( index, oldTerrainTypeID );
+			}
+
+			// Rebuild the pathfinding clusters around the tile.
+			mPathHierarchy.TerrainChanged( tile.mTilePos );
+		}
+	}
 }
 
 
-void Map::TileChanged( const Iterator& tile )
+void Map::UpdateConnectivity()
 {
-	// Fire the change callback.
-	OnTileChanged.Invoke( tile );
+	if( mIsConnectivityUpToDate )
+	{
+		// If the connectivity data is already up to date, don't rebuild it.
+		return;
+	}
+
+	size_t tileCount = mTerrainTypeIDs.size();
+	int movementTypeCount = mScenario->MovementTypes.GetRecordCount();
+
+	mConnectivityLabels.resize( movementTypeCount );
+	mNextConnectivityLabels.assign( movementTypeCount, 0 );
+
+	for( int movementTypeID = 0; movementTypeID < movementTypeCount; ++movementTypeID )
+	{
+		const int* movementCosts = mScenario->GetMovementCostsByTerrainTypeID( mScenario->MovementTypes.FindByID( movementTypeID ) );
+		std::vector< int >& labels = mConnectivityLabels[ movementTypeID ];
+		labels.resize( tileCount );
+
+		for( size_t i = 0; i < tileCount; ++i )
+		{
+			// Mark impassable tiles as walls and all other tiles as unvisited.
+			short terrainTypeID = mTerrainTypeIDs[ i ];
+			bool isPassable = ( terrainTypeID > -1 && movementCosts[ terrainTypeID ] > -1 );
+			labels[ i ] = ( isPassable ? UNVISITED_CONNECTIVITY_LABEL : NO_CONNECTIVITY_LABEL );
+		}
+
+		for( size_t i = 0; i < tileCount; ++i )
+		{
+			if( labels[ i ] == UNVISITED_CONNECTIVITY_LABEL )
+			{
+				// Give each group of connected tiles a new label.
+				FloodConnectivityLabel( labels, i, UNVISITED_CONNECTIVITY_LABEL, mNextConnectivityLabels[ movementTypeID ]++ );
+			}
+		}
+	}
+
+	mIsConnectivityUpToDate = true;
+}
+
+
+bool Map::IsConnectivityUpToDate() const
+{
+	return mIsConnectivityUpToDate;
+}
+
+
+int Map::GetConnectivityLabel( const MovementType* movementType, const Vec2s& tilePos ) const
+{
+	assertion( mIsConnectivityUpToDate, "Cannot get connectivity label because the connectivity data is out of date!" );
+	assertion( IsValidTilePos( tilePos ), "Cannot get connectivity label for invalid tile (%d,%d)!", tilePos.x, tilePos.y );
+	return mConnectivityLabels[ movementType->GetID() ][ GetCompactTileIndex( tilePos ) ];
+}
+
+
+bool Map::AreTilesConnected( const MovementType* movementType, const Vec2s& firstTilePos, const Vec2s& secondTilePos ) const
+{
+	bool result = true;
+
+	if( mIsConnectivityUpToDate && firstTilePos != secondTilePos )
+	{
+		// If the connectivity data is up to date, compare the labels of the tiles.
+		// Otherwise, assume the tiles may be connected.
+		int firstLabel = GetConnectivityLabel( movementType, firstTilePos );
+		int secondLabel = GetConnectivityLabel( movementType, secondTilePos );
+		result = ( firstLabel != NO_CONNECTIVITY_LABEL && firstLabel == secondLabel );
+	}
+
+	return result;
+}
+
+
+void Map::BuildOccupancy( const Faction* faction, SearchContext& context ) const
+{
+	for( auto it = mUnits.begin(); it != mUnits.end(); ++it )
+	{
+		const Unit* unit = *it;
+
+		if( unit->IsAlive() )
+		{
+			// Mark the tile of every living Unit as friendly or enemy to the Faction, so the search never has to look up Units.
+			// (Dead Units have already been removed from their tiles, but still remember their last position.)
+			bool isFriendly = ( unit->GetOwner() == faction );
+			context.SetTileOccupancy( GetCompactTileIndex( unit->GetTilePos() ),
+				( isFriendly ? SearchContext::OCCUPANCY_FRIENDLY : SearchContext::OCCUPANCY_ENEMY ) );
+		}
+	}
+}
+
+
+void Map::RelaxMultiTurnNode( SearchContext& context, size_t tileIndex, size_t tileCount, int turnIndex, PrimaryDirection previousDirection,
+	int key, int remainingSupplies, bool isFriendlyOccupied ) const
+{
+	SearchContext::OpenList& openList = context.GetOpenList();
+	size_t nodeIndex = ( (size_t) turnIndex * tileCount + tileIndex );
+
+	// A tile the Unit can stop on is never worth entering on a later turn than it was already reached (the Unit could
+	// have waited there instead), so skip it once it has been closed on this turn or any earlier one. A tile occupied by a
+	// friendly Unit can't be waited on, so each of its turns is searched separately.
+	int firstTurnIndex = ( isFriendlyOccupied ? turnIndex : 0 );
+
+	for( int i = firstTurnIndex; i <= turnIndex; ++i )
+	{
+		if( context.IsClosed( (size_t) i * tileCount + tileIndex ) )
+		{
+			return;
+		}
+	}
+
+	if( !openList.hasIndex( nodeIndex ) )
+	{
+		// If the node isn't already on the open list, add it.
+		context.SetPreviousTileDirection( nodeIndex, previousDirection );
+		context.SetBestTotalCostToEnter( nodeIndex, key );
+		context.SetRemainingSupplies( nodeIndex, remainingSupplies );
+		openList.insert( key, nodeIndex );
+	}
+	else if( key < context.GetBestTotalCostToEnter( nodeIndex ) ||
+			 ( key == context.GetBestTotalCostToEnter( nodeIndex ) && remainingSupplies > context.GetRemainingSupplies( nodeIndex ) ) )
+	{
+		// If the node is already on the open list but takes longer to reach (or leaves the Unit with fewer supplies),
+		// update the value.
+		context.SetPreviousTileDirection( nodeIndex, previousDirection );
+		context.SetBestTotalCostToEnter( nodeIndex, key );
+		context.SetRemainingSupplies( nodeIndex, remainingSupplies );
+		openList.update( key, nodeIndex );
+	}
+}
+
+
+void Map::InvalidateConnectivity()
+{
+	mIsConnectivityUpToDate = false;
+}
+
+
+void Map::UpdateConnectivityAroundTile( size_t tileIndex, short oldTerrainTypeID )
+{
+	Vec2s tilePos = GetTilePosFromCompactIndex( tileIndex );
+	short newTerrainTypeID = mTerrainTypeIDs[ tileIndex ];
+
+	for( size_t movementTypeID = 0; movementTypeID < mConnectivityLabels.size(); ++movementTypeID )
+	{
+		const int* movementCosts = mScenario->GetMovementCostsByTerrainTypeID( mScenario->MovementTypes.FindByID( (int) movementTypeID ) );
+		std::vector< int >& labels = mConnectivityLabels[ movementTypeID ];
+
+		bool wasPassable = ( oldTerrainTypeID > -1 && movementCosts[ oldTerrainTypeID ] > -1 );
+		bool isPassable = ( newTerrainTypeID > -1 && movementCosts[ newTerrainTypeID ] > -1 );
+
+		if( wasPassable == isPassable )
+		{
+			// If the passability of the tile didn't change, the labels stay the same.
+			continue;
+		}
+
+		if( isPassable )
+		{
+			// If the tile became passable, it joins all adjacent groups together.
+			int label = NO_CONNECTIVITY_LABEL;
+
+			for( size_t i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
+			{
+				Vec2s adjacentPos = ( tilePos + CARDINAL_DIRECTIONS[ i ].GetOffset() );
+
+				if( IsValidTilePos( adjacentPos ) )
+				{
+					size_t adjacentIndex = GetCompactTileIndex( adjacentPos );
+					int adjacentLabel = labels[ adjacentIndex ];
+
+					if( label == NO_CONNECTIVITY_LABEL )
+					{
+						// Use the label of the first adjacent group.
+						label = adjacentLabel;
+					}
+					else if( adjacentLabel != NO_CONNECTIVITY_LABEL && adjacentLabel != label )
+					{
+						// Merge any other adjacent groups into the first one.
+						FloodConnectivityLabel( labels, adjacentIndex, adjacentLabel, label );
+					}
+				}
+			}
+
+			if( label == NO_CONNECTIVITY_LABEL )
+			{
+				// If the tile isn't next to any group, start a new one.
+				label = mNextConnectivityLabels[ movementTypeID ]++;
+			}
+
+			labels[ tileIndex ] = label;
+		}
+		else
+		{
+			// If the tile became impassable, it may split its group apart, so relabel each adjacent part of the group.
+			int oldLabel = labels[ tileIndex ];
+			labels[ tileIndex ] = NO_CONNECTIVITY_LABEL;
+
+			for( size_t i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
+			{
+				Vec2s adjacentPos = ( tilePos + CARDINAL_DIRECTIONS[ i ].GetOffset() );
+
+				if( IsValidTilePos( adjacentPos ) && labels[ GetCompactTileIndex( adjacentPos ) ] == oldLabel )
+				{
+					FloodConnectivityLabel( labels, GetCompactTileIndex( adjacentPos ), oldLabel, mNextConnectivityLabels[ movementTypeID ]++ );
+				}
+			}
+		}
+	}
+}
+
+
+void Map::FloodConnectivityLabel( std::vector< int >& labels, size_t startIndex, int oldLabel, int newLabel )
+{
+	assertion( oldLabel != newLabel, "Cannot replace connectivity label %d with itself!", oldLabel );
+
+	// Relabel the starting tile.
+	labels[ startIndex ] = newLabel;
+	mConnectivityFloodStack.clear();
+	mConnectivityFloodStack.push_back( startIndex );
+
+	while( !mConnectivityFloodStack.empty() )
+	{
+		size_t tileIndex = mConnectivityFloodStack.back();
+		mConnectivityFloodStack.pop_back();
+		Vec2s tilePos = GetTilePosFromCompactIndex( tileIndex );
+
+		for( size_t i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
+		{
+			Vec2s adjacentPos = ( tilePos + CARDINAL_DIRECTIONS[ i ].GetOffset() );
+
+			if( IsValidTilePos( adjacentPos ) )
+			{
+				size_t adjacentIndex = GetCompactTileIndex( adjacentPos );
+
+				if( labels[ adjacentIndex ] == oldLabel )
+				{
+					// Relabel every connected tile with the old label.
+					labels[ adjacentIndex ] = newLabel;
+					mConnectivityFloodStack.push_back( adjacentIndex );
+				}
+			}
+		}
+	}
+}
+
+
+size_t Map::GetCompactTileIndex( const Vec2s& tilePos ) const
+{
+	// Return the index of the tile within the current bounds of the Map.
+	return ( (size_t) tilePos.y * (size_t) GetWidth() + (size_t) tilePos.x );
+}
+
+
+Vec2s Map::GetTilePosFromCompactIndex( size_t compactIndex ) const
+{
+	return Vec2s( (short) ( compactIndex % GetWidth() ), (short) ( compactIndex / GetWidth() ) );
+}
+
+
+short Map::GetTerrainTypeID( size_t compactIndex ) const
+{
+	return mTerrainTypeIDs[ compactIndex ];
+}
+
+
+Faction* Map::GetTileOwner( size_t compactIndex ) const
+{
+	return mTileOwners[ compactIndex ];
+}
+
+
+int Map::CalculateIncome( const Faction* faction ) const
+{
+	int income = 0;
+
+	for( size_t i = 0; i < mTileOwners.size(); ++i )
+	{
+		if( mTileOwners[ i ] == faction )
+		{
+			// Add the income for each Tile owned by the Faction.
+			assertion( mTerrainTypeIDs[ i ] > -1, "Cannot get income for tile %d because it does not have a valid TerrainType!", i );
+			income += mScenario->TerrainTypes.FindByID( mTerrainTypeIDs[ i ] )->GetIncome();
+		}
+	}
+
+	return income;
+}
+
+
+void Map::FlushChangedTiles()
+{
+	for( size_t i = 0; i < mChangedTiles.size(); ++i )
+	{
+		// Clear the changed flag and fire the change callback for each changed Tile.
+		Iterator tile = GetTile( mChangedTiles[ i ] );
+		tile->mIsChanged = false;
+		OnTileChanged.Invoke( tile );
+	}
+
+	// Clear the list of changed tiles.
+	mChangedTiles.clear();
+}
+
+
+void Map::TileChanged( Tile* tile )
+{
+	// Queue the Tile to be reported on the next flush.
+	mChangedTiles.push_back( tile->mTilePos );
 }
 
 
@@ -745,5 +1620,11 @@ void Map::UnitMoved( Unit* unit, const Path& path )
 
 void Map::UnitDied( Unit* unit )
 {
-	// TODO
+	Iterator tile = unit->GetTile();
+
+	if( tile.IsValid() && tile->GetUnit() == unit )
+	{
+		// Free the dead Unit's tile (which also invalidates any previous search results).
+		tile->ClearUnit();
+	}
 }
@@ -27,31 +27,20 @@ namespace mage
 
 		bool IsCapturable() const;
 
-		void Open( int searchIndex );
-		bool IsOpen( int searchIndex ) const;
-		void Close( int searchIndex );
-		bool IsClosed( int searchIndex ) const;
-
-		void SetPreviousTileDirection( PrimaryDirection direction );
-		PrimaryDirection GetPreviousTileDirection() const;
-
-		void SetBestTotalCostToEnter( int totalCostToEnter );
-		int GetBestTotalCostToEnter() const;
-
 	private:
 		void SetUnit( Unit* unit );
 		void ClearUnit();
+		void AddToOwner();
+		void RemoveFromOwner();
+		void Changed();
+		void SyncToMap();
 
-		PrimaryDirection mPreviousTileDirection;
-		int mBestTotalCostToEnter;
-		int mLastOpenedSearchIndex;
-		int mLastClosedSearchIndex;
 		TerrainType* mTerrainType;
 		Faction* mOwner;
 		Unit* mUnit;
-
-	public:
-		Event<> OnChanged;
+		Map* mMap;
+		Vec2s mTilePos;
+		bool mIsChanged;
 
 		friend class Map;
 		friend class Unit;
@@ -66,19 +55,44 @@ namespace mage
 	public:
 		static const char* const MAPS_FOLDER_PATH;
 		static const char* const MAP_FILE_EXTENSION;
+		static const int DEFAULT_MAX_TURN_COUNT = 8;
 
 		typedef std::vector< Faction* > Factions;
 		typedef std::vector< Unit* > Units;
 		typedef std::vector< Iterator > Tiles;
-		typedef std::set< Iterator > TileSet;
 
 		typedef Delegate< void, const Map::Iterator& > OnTileChangedCallback;
 
-		typedef Delegate< void, Player* > ForEachPlayerCallback;
-		typedef Delegate< void, const Player* > ForEachConstPlayerCallback;
-		typedef Delegate< void, Unit* > ForEachUnitCallback;
-		typedef Delegate< void, const Unit* > ForEachConstUnitCallback;
-		typedef Delegate< void, const Iterator&, const Unit* > ForEachReachableTileCallback;
+		typedef FunctionRef< void, Player* > ForEachPlayerCallback;
+		typedef FunctionRef< void, const Player* > ForEachConstPlayerCallback;
+		typedef FunctionRef< void, Unit* > ForEachUnitCallback;
+		typedef FunctionRef< void, const Unit* > ForEachConstUnitCallback;
+		typedef FunctionRef< void, const Iterator&, const Unit* > ForEachReachableTileCallback;
+
+		/**
+		 * A starting point for a search over the Map.
+		 */
+		struct SearchSource
+		{
+			Vec2s tilePos;
+			int movementRange;
+		};
+
+		typedef std::vector< SearchSource > SearchSources;
+
+		/**
+		 * An attack that a Unit could make against a target Unit after moving to a tile.
+		 */
+		struct AttackOption
+		{
+			const Unit* attacker;
+			const Unit* target;
+			Vec2s tilePos;
+			int weaponIndex;
+			int damagePercentage;
+		};
+
+		typedef std::vector< AttackOption > AttackOptions;
 
 		static std::string FormatMapPath( const std::string& mapName );
 
@@ -115,28 +129,78 @@ namespace mage
 		void ForEachUnit( ForEachUnitCallback callback );
 		void ForEachUnit( ForEachConstUnitCallback callback ) const;
 
-		void FindReachableTiles( const Unit* unit, TileSet& result );
+		const TileIndexSet& FindReachableTiles( const Unit* unit );
+		void FindReachableTiles( const Unit* unit, SearchContext& context ) const;
+		void FindReachableTilesFromSources( const MovementType* movementType, const SearchSources& sources, SearchContext& context, const Faction* faction = nullptr ) const;
 		void ForEachReachableTile( const Unit* unit, ForEachReachableTileCallback callback );
 		void FindBestPathToTile( const Unit* unit, const Vec2s& tilePos, Path& result );
+		bool FindBestPathToTile( const Unit* unit, const Vec2s& tilePos, Path& result, SearchContext& context ) const;
+		bool IsSearchCurrent( const SearchContext& context, const Unit* unit ) const;
+		bool BuildPathFromSearch( const SearchContext& context, const Vec2s& tilePos, Path& result ) const;
+		bool FindHierarchicalPath( const MovementType* movementType, const Vec2s& originPos, const Vec2s& goalPos, Path& result );
+		bool FindMultiTurnPath( const Unit* unit, const Vec2s& tilePos, Path& result, int maxTurnCount = DEFAULT_MAX_TURN_COUNT );
+		bool FindMultiTurnPath( const Unit* unit, const Vec2s& tilePos, Path& result, SearchContext& context, int maxTurnCount = DEFAULT_MAX_TURN_COUNT ) const;
+
+		void FindAttackOptions( const Faction* faction, AttackOptions& result );
+		void FindAttackOptions( const Faction* faction, AttackOptions& result, SearchContext& context ) const;
+
+		size_t GetCompactTileIndex( const Vec2s& tilePos ) const;
+		Vec2s GetTilePosFromCompactIndex( size_t compactIndex ) const;
+		short GetTerrainTypeID( size_t compactIndex ) const;
+		Faction* GetTileOwner( size_t compactIndex ) const;
+
+		void UpdateConnectivity();
+		bool IsConnectivityUpToDate() const;
+		int GetConnectivityLabel( const MovementType* movementType, const Vec2s& tilePos ) const;
+		bool AreTilesConnected( const MovementType* movementType, const Vec2s& firstTilePos, const Vec2s& secondTilePos ) const;
 		Event< Unit*, const Path& > OnUnitMoved;
 
 		Scenario* GetScenario() const;
 
-		int ReserveSearchIndex();
+		int CalculateIncome( const Faction* faction ) const;
 
-	private:
-		typedef FixedSizeMinHeap< MAX_TILES, int, Iterator > OpenList;
+		void FlushChangedTiles();
 
-		void TileChanged( const Iterator& tile );
+	private:
+		static const int NO_CONNECTIVITY_LABEL = -1;
+		static const int UNVISITED_CONNECTIVITY_LABEL = -2;
+
+		void InitTiles( const RectS& area );
+		void Resized( const Vec2s& oldSize, const Vec2s& newSize );
+		void RebuildTileData();
+		void SyncTileData( const Tile& tile );
+		void InvalidateConnectivity();
+		void UpdateConnectivityAroundTile( size_t tileIndex, short oldTerrainTypeID );
+		void FloodConnectivityLabel( std::vector< int >& labels, size_t startIndex, int oldLabel, int newLabel );
+		void BuildOccupancy( const Faction* faction, SearchContext& context ) const;
+		void RelaxMultiTurnNode( SearchContext& context, size_t tileIndex, size_t tileCount, int turnIndex, PrimaryDirection previousDirection,
+			int key, int remainingSupplies, bool isFriendlyOccupied ) const;
+
+		void TileChanged( Tile* tile );
 		void UnitMoved( Unit* unit, const Path& path );
 		void UnitDied( Unit* unit );
 
 		bool mIsInitialized;
-		int mNextSearchIndex;
+		unsigned int mRevision;
 		Scenario* mScenario;
 		Units mUnits;
 		Factions mFactions;
-		OpenList mOpenList;
+		SearchContext mSearchContext;
+		SearchContext mReachableTilesContext;
+		std::vector< Vec2s > mChangedTiles;
+
+		// Dense per-tile data (indexed by compact tile index) so that searches only touch the data they need.
+		std::vector< short > mTerrainTypeIDs;
+		std::vector< Faction* > mTileOwners;
+		std::vector< Unit* > mTileUnits;
+
+		// Connected component labels for each MovementType (indexed by MovementType ID, then by compact tile index).
+		bool mIsConnectivityUpToDate;
+		std::vector< std::vector< int > > mConnectivityLabels;
+		std::vector< int > mNextConnectivityLabels;
+		std::vector< size_t > mConnectivityFloodStack;
+
+		PathHierarchy mPathHierarchy;
 
 	public:
 		Event< const Iterator& > OnTileChanged;
@@ -36,12 +36,11 @@ void MapView::Init( Map* map )
 	// Make sure a default Font was loaded.
 	assertion( mDefaultFont, "Cannot initialize " STRINGIFY( MapView ) " without a valid default Font!" );
 
-	// Resize to fill the whole tile buffer (for initialization).
-	mTileSprites.ForEachTileInMaxArea( [this]( const TileSpritesGrid::Iterator& tileSprite )
-	{
-		// Initialize all TileSprites.
-		tileSprite->Init( this, tileSprite.GetPosition() );
-	});
+	// Initialize any TileSprites that have already been allocated.
+	InitTileSprites( mTileSprites.GetAllocatedBounds() );
+
+	// Initialize TileSprites as they are allocated.
+	mTileSprites.OnChunkAllocated.AddCallback( this, &MapView::InitTileSprites );
 
 	// Create initial TileSprites.
 	MapResized( Vec2s::ZERO, mMap->GetSize() );
@@ -71,6 +70,9 @@ void MapView::Destroy()
 	// Remove the resize callback.
 	mMap->OnResize.RemoveCallback( this, &MapView::MapResized );
 
+	// Remove the allocation callback.
+	mTileSprites.OnChunkAllocated.RemoveCallback( this, &MapView::InitTileSprites );
+
 	// Reset the Map reference.
 	mMap = nullptr;
 }
@@ -78,6 +80,9 @@ void MapView::Destroy()
 
 void MapView::Update( float elapsedTime )
 {
+	// Refresh the TileSprites of any tiles that changed since the last update.
+	mMap->FlushChangedTiles();
+
 	mTileSprites.ForEachTile( [ this, elapsedTime ]( const TileSpritesGrid::Iterator& tileSprite )
 	{
 		// Update the TileSprite that represents this Tile.
@@ -369,20 +374,30 @@ void MapView::MapResized( const Vec2s& oldSize, const Vec2s& newSize )
 	short refreshHeight = std::max( oldSize.y, newSize.y );
 	RectS area( 0, 0, refreshWidth, refreshHeight );
 
+	// Resize the TileSprites grid (allocating any new TileSprites).
+	mTileSprites.Resize( newSize );
+
 	mTileSprites.ForEachTileInArea( area, []( const TileSpritesGrid::Iterator& tileSprite )
 	{
 		// Update the sprites of all TileSprites in the refresh area.
 		tileSprite->UpdateSprite();
 	});
 
-	// Resize the TileSprites grid.
-	mTileSprites.Resize( newSize );
-
 	// Refresh the Camera bounds.
 	mCamera.SetWorldBounds( GetCameraBounds() );
 }
 
 
+void MapView::InitTileSprites( const RectS& area )
+{
+	mTileSprites.ForEachTileInArea( area, [ this ]( const TileSpritesGrid::Iterator& tileSprite )
+	{
+		// Initialize all TileSprites in the area.
+		tileSprite->Init( this, tileSprite.GetPosition() );
+	});
+}
+
+
 void MapView::TileChanged( const Map::Iterator& tile )
 {
 	// Update the TileSprite for this tile.
@@ -66,6 +66,7 @@ namespace mage
 		bool IsInitialized() const;
 
 	private:
+		void InitTileSprites( const RectS& area );
 		void MapResized( const Vec2s& oldSize, const Vec2s& newSize );
 		void TileChanged( const Map::Iterator& tile );
 		void UnitSpriteSelected( UnitSprite* unitSprite );
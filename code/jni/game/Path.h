@@ -28,6 +28,11 @@ namespace mage
 		Vec2f Interpolate( float percentage ) const;
 		void Clear();
 
+		void EndTurn();
+		size_t GetTurnCount() const;
+		size_t GetTurnEndIndex( size_t turnIndex ) const;
+		size_t GetTurnOfWaypoint( size_t index ) const;
+
 		size_t GetLength() const;
 		size_t GetWaypointCount() const;
 		bool IsValid() const;
@@ -35,6 +40,7 @@ namespace mage
 	protected:
 		Vec2s mOrigin;
 		std::vector< PrimaryDirection > mDirections;
+		std::vector< size_t > mTurnEndIndices;
 
 	public:
 		Event<> OnChanged;
@@ -46,7 +52,8 @@ namespace mage
 
 	inline Path::Path( const Path& other ) :
 		mOrigin( other.mOrigin ),
-		mDirections( other.mDirections )
+		mDirections( other.mDirections ),
+		mTurnEndIndices( other.mTurnEndIndices )
 	{
 		// Don't copy event callbacks.
 	}
@@ -57,6 +64,7 @@ namespace mage
 		// Don't copy event callbacks.
 		mOrigin = other.mOrigin;
 		mDirections = other.mDirections;
+		mTurnEndIndices = other.mTurnEndIndices;
 	}
 
 
@@ -146,6 +154,13 @@ namespace mage
 		// Remove all directions after the specified index.
 		assertion( index < mDirections.size(), "Cannot remove waypoints after index because the index (%d) is out of bounds!", index );
 		mDirections.erase( mDirections.begin() + index, mDirections.end() );
+
+		while( !mTurnEndIndices.empty() && mTurnEndIndices.back() >= index )
+		{
+			// Remove any turns that ended at or after the index.
+			mTurnEndIndices.pop_back();
+		}
+
 		OnChanged.Invoke();
 	}
 
@@ -175,10 +190,47 @@ namespace mage
 	inline void Path::Clear()
 	{
 		mDirections.clear();
+		mTurnEndIndices.clear();
 		OnChanged.Invoke();
 	}
 
 
+	inline void Path::EndTurn()
+	{
+		// Mark the current destination of the path as the end of a turn.
+		assertion( mTurnEndIndices.empty() || mTurnEndIndices.back() < mDirections.size(), "Cannot end a turn on a path that didn't move since the last turn ended!" );
+		mTurnEndIndices.push_back( mDirections.size() );
+	}
+
+
+	inline size_t Path::GetTurnCount() const
+	{
+		return ( mTurnEndIndices.size() + 1 );
+	}
+
+
+	inline size_t Path::GetTurnEndIndex( size_t turnIndex ) const
+	{
+		// Return the index of the last waypoint reached during the turn (the destination for the last turn).
+		assertion( turnIndex < GetTurnCount(), "Turn index %d is out of bounds! (%d turns)", turnIndex, GetTurnCount() );
+		return ( turnIndex < mTurnEndIndices.size() ? mTurnEndIndices[ turnIndex ] : mDirections.size() );
+	}
+
+
+	inline size_t Path::GetTurnOfWaypoint( size_t index ) const
+	{
+		size_t turnIndex = 0;
+
+		while( turnIndex < mTurnEndIndices.size() && mTurnEndIndices[ turnIndex ] < index )
+		{
+			// Find the first turn that ends at or after the waypoint.
+			++turnIndex;
+		}
+
+		return turnIndex;
+	}
+
+
 	inline size_t Path::GetLength() const
 	{
 		return mDirections.size();
@@ -0,0 +1,534 @@
+#include "androidwars_sim.h"
+
+using namespace mage;
+
+
+const short PathHierarchy::CLUSTER_SIZE;
+const size_t PathHierarchy::NO_TILE_INDEX;
+
+
+PathHierarchy::PathHierarchy() :
+	mMap( nullptr ),
+	mIsLayoutValid( false ),
+	mHasDirtyClusters( false ),
+	mClusterCountX( 0 ),
+	mClusterCountY( 0 ),
+	mMovementTypeCount( 0 )
+{ }
+
+
+PathHierarchy::~PathHierarchy() { }
+
+
+void PathHierarchy::Init( const Map* map )
+{
+	assertion( map, "Cannot initialize PathHierarchy without a valid Map!" );
+	mMap = map;
+	Invalidate();
+}
+
+
+void PathHierarchy::Destroy()
+{
+	mMap = nullptr;
+	Invalidate();
+
+	// Free all cluster data.
+	mClusters.clear();
+	mIsClusterDirty.clear();
+}
+
+
+void PathHierarchy::Invalidate()
+{
+	// Rebuild all clusters the next time the PathHierarchy is used.
+	mIsLayoutValid = false;
+}
+
+
+void PathHierarchy::TerrainChanged( const Vec2s& tilePos )
+{
+	if( !mIsLayoutValid )
+	{
+		// If everything will be rebuilt anyway, there is nothing to do.
+		return;
+	}
+
+	short clusterX = ( tilePos.x / CLUSTER_SIZE );
+	short clusterY = ( tilePos.y / CLUSTER_SIZE );
+	short localX = ( tilePos.x % CLUSTER_SIZE );
+	short localY = ( tilePos.y % CLUSTER_SIZE );
+
+	// Rebuild the cluster containing the tile.
+	MarkClusterDirty( clusterX, clusterY );
+
+	// If the tile is on the border of its cluster, the portals of the neighboring cluster may have changed as well.
+	if( localX == 0 ) MarkClusterDirty( clusterX - 1, clusterY );
+	if( localX == CLUSTER_SIZE - 1 ) MarkClusterDirty( clusterX + 1, clusterY );
+	if( localY == 0 ) MarkClusterDirty( clusterX, clusterY - 1 );
+	if( localY == CLUSTER_SIZE - 1 ) MarkClusterDirty( clusterX, clusterY + 1 );
+}
+
+
+void PathHierarchy::Update()
+{
+	assertion( mMap, "Cannot update PathHierarchy that has not been initialized!" );
+
+	if( !mIsLayoutValid )
+	{
+		// If the Map was resized or reloaded, lay out the clusters again and rebuild all of them.
+		mClusterCountX = (short) ( ( mMap->GetWidth() + CLUSTER_SIZE - 1 ) / CLUSTER_SIZE );
+		mClusterCountY = (short) ( ( mMap->GetHeight() + CLUSTER_SIZE - 1 ) / CLUSTER_SIZE );
+		mMovementTypeCount = mMap->GetScenario()->MovementTypes.GetRecordCount();
+
+		size_t clusterCount = ( (size_t) mClusterCountX * (size_t) mClusterCountY );
+		mClusters.assign( clusterCount * mMovementTypeCount, Cluster() );
+		mIsClusterDirty.assign( clusterCount, true );
+		mHasDirtyClusters = true;
+		mIsLayoutValid = true;
+	}
+
+	if( mHasDirtyClusters )
+	{
+		for( size_t clusterIndex = 0; clusterIndex < mIsClusterDirty.size(); ++clusterIndex )
+		{
+			if( mIsClusterDirty[ clusterIndex ] )
+			{
+				for( int movementTypeID = 0; movementTypeID < mMovementTypeCount; ++movementTypeID )
+				{
+					// Rebuild each dirty cluster for every MovementType.
+					BuildCluster( movementTypeID, (int) clusterIndex );
+				}
+
+				mIsClusterDirty[ clusterIndex ] = false;
+			}
+		}
+
+		mHasDirtyClusters = false;
+	}
+}
+
+
+bool PathHierarchy::FindPath( const MovementType* movementType, const Vec2s& originPos, const Vec2s& goalPos, Path& result )
+{
+	assertion( mMap->IsValidTilePos( originPos ), "Cannot find path from invalid tile (%d,%d)!", originPos.x, originPos.y );
+
+	// Clear the list of results.
+	result.Clear();
+	result.SetOrigin( originPos );
+
+	if( !mMap->IsValidTilePos( goalPos ) )
+	{
+		// If the goal is off the Map, there is no path to it.
+		return false;
+	}
+
+	// Make sure all clusters are up to date.
+	Update();
+
+	const int* movementCosts = mMap->GetScenario()->GetMovementCostsByTerrainTypeID( movementType );
+	int minimumMovementCost = mMap->GetScenario()->GetMinimumMovementCost( movementType );
+	size_t originIndex = mMap->GetCompactTileIndex( originPos );
+	size_t goalIndex = mMap->GetCompactTileIndex( goalPos );
+
+	if( originIndex == goalIndex )
+	{
+		// If the origin is the goal, the path is empty.
+		return true;
+	}
+
+	if( GetCostToEnter( movementCosts, originIndex ) < 0 || GetCostToEnter( movementCosts, goalIndex ) < 0 )
+	{
+		// If the goal can't be entered, there is no path to it.
+		// Portals only exist on passable tiles, so the origin must be passable as well.
+		return false;
+	}
+	int originClusterIndex = GetClusterIndex( originPos );
+	int goalClusterIndex = GetClusterIndex( goalPos );
+
+	if( originClusterIndex == goalClusterIndex )
+	{
+		// If both tiles are in the same cluster, try to find a path without leaving the cluster.
+		SearchArea( movementCosts, originIndex, GetClusterArea( originClusterIndex ), false, goalIndex );
+
+		if( mSearchContext.IsClosed( goalIndex ) )
+		{
+			AddPathToTile( goalIndex, result );
+			return true;
+		}
+	}
+
+	// Find the cost from the origin to each portal of its cluster.
+	Cluster& originCluster = GetCluster( movementType->GetID(), originClusterIndex );
+	SearchArea( movementCosts, originIndex, GetClusterArea( originClusterIndex ), false, NO_TILE_INDEX );
+	mOriginPortalCosts.resize( originCluster.portalTiles.size() );
+
+	for( size_t i = 0; i < originCluster.portalTiles.size(); ++i )
+	{
+		size_t portalIndex = originCluster.portalTiles[ i ];
+		mOriginPortalCosts[ i ] = ( mSearchContext.IsClosed( portalIndex ) ? mSearchContext.GetBestTotalCostToEnter( portalIndex ) : -1 );
+	}
+
+	// Find the cost from each portal of the goal's cluster to the goal.
+	Cluster& goalCluster = GetCluster( movementType->GetID(), goalClusterIndex );
+	SearchArea( movementCosts, goalIndex, GetClusterArea( goalClusterIndex ), true, NO_TILE_INDEX );
+	mGoalPortalCosts.resize( goalCluster.portalTiles.size() );
+
+	for( size_t i = 0; i < goalCluster.portalTiles.size(); ++i )
+	{
+		size_t portalIndex = goalCluster.portalTiles[ i ];
+		mGoalPortalCosts[ i ] = ( mSearchContext.IsClosed( portalIndex ) ? mSearchContext.GetBestTotalCostToEnter( portalIndex ) : -1 );
+	}
+
+	// Search the graph of portals.
+	size_t tileCount = ( (size_t) mMap->GetWidth() * (size_t) mMap->GetHeight() );
+	mAbstractSearchContext.BeginSearch( tileCount );
+	mPreviousNodes.resize( tileCount );
+
+	SearchContext::OpenList& openList = mAbstractSearchContext.GetOpenList();
+	mPreviousNodes[ originIndex ] = NO_TILE_INDEX;
+	mAbstractSearchContext.SetBestTotalCostToEnter( originIndex, 0 );
+	openList.insert( 0, originIndex );
+
+	bool foundPath = false;
+
+	while( !openList.isEmpty() )
+	{
+		// Pop the first node off the open list.
+		size_t nodeIndex = openList.popMinIndex();
+		mAbstractSearchContext.Close( nodeIndex );
+
+		if( nodeIndex == goalIndex )
+		{
+			// If this is the goal, stop searching.
+			foundPath = true;
+			break;
+		}
+
+		int nodeCost = mAbstractSearchContext.GetBestTotalCostToEnter( nodeIndex );
+
+		if( nodeIndex == originIndex )
+		{
+			for( size_t i = 0; i < originCluster.portalTiles.size(); ++i )
+			{
+				if( mOriginPortalCosts[ i ] > -1 )
+				{
+					// Connect the origin to each portal it can reach within its cluster.
+					RelaxNode( nodeIndex, originCluster.portalTiles[ i ], nodeCost + mOriginPortalCosts[ i ], goalPos, minimumMovementCost );
+				}
+			}
+		}
+
+		Vec2s nodePos = mMap->GetTilePosFromCompactIndex( nodeIndex );
+		int clusterIndex = GetClusterIndex( nodePos );
+		Cluster& cluster = GetCluster( movementType->GetID(), clusterIndex );
+		size_t portalCount = cluster.portalTiles.size();
+
+		for( size_t i = 0; i < portalCount; ++i )
+		{
+			if( cluster.portalTiles[ i ] != nodeIndex )
+			{
+				continue;
+			}
+
+			// Cross into the neighboring cluster.
+			size_t partnerIndex = cluster.partnerTiles[ i ];
+			RelaxNode( nodeIndex, partnerIndex, nodeCost + GetCostToEnter( movementCosts, partnerIndex ), goalPos, minimumMovementCost );
+
+			for( size_t j = 0; j < portalCount; ++j )
+			{
+				int portalCost = cluster.portalCosts[ i * portalCount + j ];
+
+				if( j != i && portalCost > -1 )
+				{
+					// Travel to each other portal of the cluster.
+					RelaxNode( nodeIndex, cluster.portalTiles[ j ], nodeCost + portalCost, goalPos, minimumMovementCost );
+				}
+			}
+
+			if( clusterIndex == goalClusterIndex && mGoalPortalCosts[ i ] > -1 )
+			{
+				// Travel from the portal to the goal.
+				RelaxNode( nodeIndex, goalIndex, nodeCost + mGoalPortalCosts[ i ], goalPos, minimumMovementCost );
+			}
+		}
+	}
+
+	if( foundPath )
+	{
+		// Collect the nodes along the path from the goal back to the origin.
+		mNodePath.clear();
+
+		for( size_t nodeIndex = goalIndex; nodeIndex != NO_TILE_INDEX; nodeIndex = mPreviousNodes[ nodeIndex ] )
+		{
+			mNodePath.push_back( nodeIndex );
+		}
+
+		for( size_t i = mNodePath.size() - 1; i > 0; --i )
+		{
+			// Refine each step between nodes into a path through the cluster of the first node.
+			size_t fromIndex = mNodePath[ i ];
+			size_t toIndex = mNodePath[ i - 1 ];
+			Vec2s fromPos = mMap->GetTilePosFromCompactIndex( fromIndex );
+			Vec2s toPos = mMap->GetTilePosFromCompactIndex( toIndex );
+			int fromClusterIndex = GetClusterIndex( fromPos );
+
+			if( fromClusterIndex != GetClusterIndex( toPos ) )
+			{
+				// If the step crosses into another cluster, the tiles are adjacent.
+				for( size_t j = 0; j < CARDINAL_DIRECTION_COUNT; ++j )
+				{
+					if( fromPos + CARDINAL_DIRECTIONS[ j ].GetOffset() == toPos )
+					{
+						result.AddDirection( CARDINAL_DIRECTIONS[ j ] );
+						break;
+					}
+				}
+			}
+			else
+			{
+				// Otherwise, find the path within the cluster.
+				SearchArea( movementCosts, fromIndex, GetClusterArea( fromClusterIndex ), false, toIndex );
+				AddPathToTile( toIndex, result );
+			}
+		}
+	}
+
+	return foundPath;
+}
+
+
+int PathHierarchy::GetClusterIndex( const Vec2s& tilePos ) const
+{
+	return ( ( tilePos.y / CLUSTER_SIZE ) * mClusterCountX + ( tilePos.x / CLUSTER_SIZE ) );
+}
+
+
+RectS PathHierarchy::GetClusterArea( int clusterIndex ) const
+{
+	// Clip the cluster to the bounds of the Map.
+	short left = (short) ( ( clusterIndex % mClusterCountX ) * CLUSTER_SIZE );
+	short top = (short) ( ( clusterIndex / mClusterCountX ) * CLUSTER_SIZE );
+	short right = std::min( (short) ( left + CLUSTER_SIZE ), mMap->GetWidth() );
+	short bottom = std::min( (short) ( top + CLUSTER_SIZE ), mMap->GetHeight() );
+	return RectS( left, top, right, bottom );
+}
+
+
+PathHierarchy::Cluster& PathHierarchy::GetCluster( int movementTypeID, int clusterIndex )
+{
+	return mClusters[ movementTypeID * mIsClusterDirty.size() + clusterIndex ];
+}
+
+
+int PathHierarchy::GetCostToEnter( const int* movementCosts, size_t tileIndex ) const
+{
+	short terrainTypeID = mMap->GetTerrainTypeID( tileIndex );
+	return ( terrainTypeID > -1 ? movementCosts[ terrainTypeID ] : -1 );
+}
+
+
+void PathHierarchy::MarkClusterDirty( short clusterX, short clusterY )
+{
+	if( clusterX >= 0 && clusterY >= 0 && clusterX < mClusterCountX && clusterY < mClusterCountY )
+	{
+		// If the cluster exists, rebuild it the next time the PathHierarchy is used.
+		mIsClusterDirty[ clusterY * mClusterCountX + clusterX ] = true;
+		mHasDirtyClusters = true;
+	}
+}
+
+
+void PathHierarchy::BuildCluster( int movementTypeID, int clusterIndex )
+{
+	const int* movementCosts = mMap->GetScenario()->GetMovementCostsByTerrainTypeID( mMap->GetScenario()->MovementTypes.FindByID( movementTypeID ) );
+	Cluster& cluster = GetCluster( movementTypeID, clusterIndex );
+	RectS area = GetClusterArea( clusterIndex );
+
+	// Find the portals along each side of the cluster.
+	cluster.portalTiles.clear();
+	cluster.partnerTiles.clear();
+
+	for( size_t i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
+	{
+		AddPortals( movementCosts, cluster, area, CARDINAL_DIRECTIONS[ i ] );
+	}
+
+	// Find the cost of travelling between each pair of portals without leaving the cluster.
+	size_t portalCount = cluster.portalTiles.size();
+	cluster.portalCosts.assign( portalCount * portalCount, -1 );
+
+	for( size_t i = 0; i < portalCount; ++i )
+	{
+		SearchArea( movementCosts, cluster.portalTiles[ i ], area, false, NO_TILE_INDEX );
+
+		for( size_t j = 0; j < portalCount; ++j )
+		{
+			size_t portalIndex = cluster.portalTiles[ j ];
+
+			if( mSearchContext.IsClosed( portalIndex ) )
+			{
+				cluster.portalCosts[ i * portalCount + j ] = mSearchContext.GetBestTotalCostToEnter( portalIndex );
+			}
+		}
+	}
+}
+
+
+void PathHierarchy::AddPortals( const int* movementCosts, Cluster& cluster, const RectS& area, PrimaryDirection direction )
+{
+	Vec2s offset = direction.GetOffset();
+
+	// Walk along the side of the cluster facing the direction.
+	Vec2s startPos( ( offset.x > 0 ? area.Right - 1 : area.Left ), ( offset.y > 0 ? area.Bottom - 1 : area.Top ) );
+	Vec2s step( ( offset.x == 0 ? 1 : 0 ), ( offset.y == 0 ? 1 : 0 ) );
+	short sideLength = ( offset.x == 0 ? area.Right - area.Left : area.Bottom - area.Top );
+	short runStart = -1;
+
+	for( short i = 0; i <= sideLength; ++i )
+	{
+		bool isOpen = false;
+		Vec2s tilePos( startPos.x + step.x * i, startPos.y + step.y * i );
+		Vec2s partnerPos = ( tilePos + offset );
+
+		if( i < sideLength && mMap->IsValidTilePos( partnerPos ) )
+		{
+			// Check whether both sides of the border can be entered here.
+			isOpen = ( GetCostToEnter( movementCosts, mMap->GetCompactTileIndex( tilePos ) ) > -1 &&
+					   GetCostToEnter( movementCosts, mMap->GetCompactTileIndex( partnerPos ) ) > -1 );
+		}
+
+		if( isOpen && runStart < 0 )
+		{
+			// Start a new run of open tiles.
+			runStart = i;
+		}
+		else if( !isOpen && runStart > -1 )
+		{
+			// At the end of each run of open tiles, add a portal in the middle of the run.
+			// The neighboring cluster finds the same run, so the portals on both sides line up.
+			short middle = ( runStart + ( i - 1 - runStart ) / 2 );
+			Vec2s portalPos( startPos.x + step.x * middle, startPos.y + step.y * middle );
+			cluster.portalTiles.push_back( mMap->GetCompactTileIndex( portalPos ) );
+			cluster.partnerTiles.push_back( mMap->GetCompactTileIndex( portalPos + offset ) );
+			runStart = -1;
+		}
+	}
+}
+
+
+void PathHierarchy::SearchArea( const int* movementCosts, size_t originIndex, const RectS& area, bool isReversed, size_t goalIndex )
+{
+	// Start a new search.
+	mSearchContext.BeginSearch( (size_t) mMap->GetWidth() * (size_t) mMap->GetHeight() );
+	SearchContext::OpenList& openList = mSearchContext.GetOpenList();
+
+	// Add the origin tile to the open list.
+	mSearchContext.SetPreviousTileDirection( originIndex, PrimaryDirection::NONE );
+	mSearchContext.SetBestTotalCostToEnter( originIndex, 0 );
+	openList.insert( 0, originIndex );
+
+	while( !openList.isEmpty() )
+	{
+		// Pop the first element off the open list.
+		size_t tileIndex = openList.popMinIndex();
+		mSearchContext.Close( tileIndex );
+
+		if( tileIndex == goalIndex )
+		{
+			// If this is the goal tile, stop searching.
+			break;
+		}
+
+		Vec2s tilePos = mMap->GetTilePosFromCompactIndex( tileIndex );
+
+		for( size_t i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
+		{
+			PrimaryDirection direction = CARDINAL_DIRECTIONS[ i ];
+			Vec2s adjacentPos = ( tilePos + direction.GetOffset() );
+
+			if( adjacentPos.x < area.Left || adjacentPos.y < area.Top || adjacentPos.x >= area.Right || adjacentPos.y >= area.Bottom )
+			{
+				// Don't leave the area.
+				continue;
+			}
+
+			size_t adjacentIndex = mMap->GetCompactTileIndex( adjacentPos );
+			int costToEnterAdjacent = GetCostToEnter( movementCosts, adjacentIndex );
+
+			if( !mSearchContext.IsClosed( adjacentIndex ) && costToEnterAdjacent > -1 )
+			{
+				// When searching backwards from a goal, the cost of each step is the cost of entering the tile the step leads to,
+				// which is the current tile.
+				int stepCost = ( isReversed ? GetCostToEnter( movementCosts, tileIndex ) : costToEnterAdjacent );
+				int adjacentTotalCost = ( mSearchContext.GetBestTotalCostToEnter( tileIndex ) + stepCost );
+
+				if( !openList.hasIndex( adjacentIndex ) )
+				{
+					// If the tile isn't already on the open list, add it.
+					mSearchContext.SetPreviousTileDirection( adjacentIndex, direction.GetOppositeDirection() );
+					mSearchContext.SetBestTotalCostToEnter( adjacentIndex, adjacentTotalCost );
+					openList.insert( adjacentTotalCost, adjacentIndex );
+				}
+				else if( adjacentTotalCost < mSearchContext.GetBestTotalCostToEnter( adjacentIndex ) )
+				{
+					// If the tile is already on the open list but has a larger total cost, update the value.
+					mSearchContext.SetPreviousTileDirection( adjacentIndex, direction.GetOppositeDirection() );
+					mSearchContext.SetBestTotalCostToEnter( adjacentIndex, adjacentTotalCost );
+					openList.update( adjacentTotalCost, adjacentIndex );
+				}
+			}
+		}
+	}
+}
+
+
+void PathHierarchy::AddPathToTile( size_t goalIndex, Path& result ) const
+{
+	std::vector< PrimaryDirection > reverseDirections;
+	Vec2s currentPos = mMap->GetTilePosFromCompactIndex( goalIndex );
+	PrimaryDirection previousDirection = mSearchContext.GetPreviousTileDirection( goalIndex );
+
+	while( previousDirection != PrimaryDirection::NONE )
+	{
+		// Construct the list of directions from the goal back to the origin tile.
+		reverseDirections.push_back( previousDirection );
+		currentPos += previousDirection.GetOffset();
+		previousDirection = mSearchContext.GetPreviousTileDirection( mMap->GetCompactTileIndex( currentPos ) );
+	}
+
+	for( auto it = reverseDirections.rbegin(); it != reverseDirections.rend(); ++it )
+	{
+		// Add the directions to the path in order.
+		PrimaryDirection direction = *it;
+		result.AddDirection( direction.GetOppositeDirection() );
+	}
+}
+
+
+void PathHierarchy::RelaxNode( size_t fromIndex, size_t toIndex, int totalCost, const Vec2s& goalPos, int minimumMovementCost )
+{
+	if( mAbstractSearchContext.IsClosed( toIndex ) )
+	{
+		// If the node has already been closed, ignore it.
+		return;
+	}
+
+	SearchContext::OpenList& openList = mAbstractSearchContext.GetOpenList();
+	int estimatedCostToGoal = ( mMap->GetTilePosFromCompactIndex( toIndex ).GetManhattanDistanceTo( goalPos ) * minimumMovementCost );
+
+	if( !openList.hasIndex( toIndex ) )
+	{
+		// If the node isn't already on the open list, add it.
+		mPreviousNodes[ toIndex ] = fromIndex;
+		mAbstractSearchContext.SetBestTotalCostToEnter( toIndex, totalCost );
+		openList.insert( totalCost + estimatedCostToGoal, toIndex );
+	}
+	else if( totalCost < mAbstractSearchContext.GetBestTotalCostToEnter( toIndex ) )
+	{
+		// If the node is already on the open list but has a larger total cost, update the value.
+		mPreviousNodes[ toIndex ] = fromIndex;
+		mAbstractSearchContext.SetBestTotalCostToEnter( toIndex, totalCost );
+		openList.update( totalCost + estimatedCostToGoal, toIndex );
+	}
+}
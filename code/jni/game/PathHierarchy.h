@@ -0,0 +1,71 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Speeds up long distance pathfinding over a Map by dividing it into square clusters. For each MovementType, the
+	 * passable crossings (portals) between neighboring clusters and the costs of travelling between portals within each
+	 * cluster are precomputed. Paths are found on the graph of portals and then refined one cluster at a time.
+	 * Clusters are rebuilt only when the terrain inside or along the border of the cluster changes.
+	 */
+	class PathHierarchy
+	{
+	public:
+		static const short CLUSTER_SIZE = 16;
+
+		PathHierarchy();
+		~PathHierarchy();
+
+		void Init( const Map* map );
+		void Destroy();
+
+		void Invalidate();
+		void TerrainChanged( const Vec2s& tilePos );
+		void Update();
+
+		bool FindPath( const MovementType* movementType, const Vec2s& originPos, const Vec2s& goalPos, Path& result );
+
+	private:
+		static const size_t NO_TILE_INDEX = (size_t) -1;
+
+		/**
+		 * The portals of a single cluster for a single MovementType.
+		 */
+		struct Cluster
+		{
+			std::vector< size_t > portalTiles;		// Tiles inside the cluster that lead to a neighboring cluster.
+			std::vector< size_t > partnerTiles;		// Tiles in the neighboring cluster that each portal leads to.
+			std::vector< int > portalCosts;			// Costs between portals (portal i to portal j at [ i * count + j ]), -1 if unreachable.
+		};
+
+		PathHierarchy( const PathHierarchy& other );
+		void operator=( const PathHierarchy& other );
+
+		int GetClusterIndex( const Vec2s& tilePos ) const;
+		RectS GetClusterArea( int clusterIndex ) const;
+		Cluster& GetCluster( int movementTypeID, int clusterIndex );
+		int GetCostToEnter( const int* movementCosts, size_t tileIndex ) const;
+		void MarkClusterDirty( short clusterX, short clusterY );
+
+		void BuildCluster( int movementTypeID, int clusterIndex );
+		void AddPortals( const int* movementCosts, Cluster& cluster, const RectS& area, PrimaryDirection direction );
+		void SearchArea( const int* movementCosts, size_t originIndex, const RectS& area, bool isReversed, size_t goalIndex );
+		void AddPathToTile( size_t goalIndex, Path& result ) const;
+		void RelaxNode( size_t fromIndex, size_t toIndex, int totalCost, const Vec2s& goalPos, int minimumMovementCost );
+
+		const Map* mMap;
+		bool mIsLayoutValid;
+		bool mHasDirtyClusters;
+		short mClusterCountX;
+		short mClusterCountY;
+		int mMovementTypeCount;
+		std::vector< Cluster > mClusters;
+		std::vector< bool > mIsClusterDirty;
+		std::vector< size_t > mPreviousNodes;
+		std::vector< int > mOriginPortalCosts;
+		std::vector< int > mGoalPortalCosts;
+		std::vector< size_t > mNodePath;
+		SearchContext mSearchContext;
+		SearchContext mAbstractSearchContext;
+	};
+}
@@ -1,10 +1,10 @@
-#include "androidwars.h"
+#include "androidwars_sim.h"
 
 using namespace mage;
 
 
 Player::Player( Game* game, Faction* faction ) :
-	mGame( game ), mFaction( faction )
+	mGame( game ), mFaction( faction ), mIsComputerControlled( false )
 {
 	assertion( mGame, "Cannot create Player without a valid Game!" );
 	assertion( mFaction, "Cannot create Player without a valid Faction!" );
@@ -24,3 +24,15 @@ Faction* Player::GetFaction() const
 {
 	return mFaction;
 }
+
+
+void Player::SetComputerControlled( bool isComputerControlled )
+{
+	mIsComputerControlled = isComputerControlled;
+}
+
+
+bool Player::IsComputerControlled() const
+{
+	return mIsComputerControlled;
+}
@@ -4,7 +4,7 @@
 namespace mage
 {
 	/**
-	 * Represents all stats for a single user-controlled Player in the game.
+	 * Represents all stats for a single Player in the game (controlled by either a user or the AIPlanner).
 	 */
 	class Player
 	{
@@ -12,12 +12,16 @@ namespace mage
 		Game* GetGame() const;
 		Faction* GetFaction() const;
 
+		void SetComputerControlled( bool isComputerControlled );
+		bool IsComputerControlled() const;
+
 	protected:
 		Player( Game* game, Faction* faction );
 		~Player();
 
 		Game* mGame;
 		Faction* mFaction;
+		bool mIsComputerControlled;
 
 		friend class Game;
 	};
@@ -0,0 +1,295 @@
+#include "androidwars_sim.h"
+
+using namespace mage;
+
+
+const int RolloutEngine::DEFAULT_MAX_TURN_COUNT;
+const int RolloutEngine::MAX_WORKER_COUNT;
+
+
+RolloutEngine::RolloutEngine() :
+	mWorkerCount( 1 ),
+	mMaxTurnCount( DEFAULT_MAX_TURN_COUNT ),
+	mSnapshot( nullptr ),
+	mSeed( 0 ),
+	mRolloutCount( 0 ),
+	mNextRolloutIndex( 0 )
+{
+	SetWorkerCount( WorkerGroup::GetDefaultWorkerCount( MAX_WORKER_COUNT ) );
+}
+
+
+RolloutEngine::~RolloutEngine() { }
+
+
+void RolloutEngine::SetWorkerCount( int workerCount )
+{
+	mWorkerCount = Mathi::Clamp( workerCount, 1, MAX_WORKER_COUNT );
+}
+
+
+void RolloutEngine::SetMaxTurnCount( int maxTurnCount )
+{
+	mMaxTurnCount = std::max( maxTurnCount, 1 );
+}
+
+
+void RolloutEngine::Run( const GameSnapshot& snapshot, int rolloutCount, uint64 seed, Result& result )
+{
+	assertion( snapshot.GetScenario(), "Cannot run rollouts from a GameSnapshot that has not been captured!" );
+
+	mSnapshot = &snapshot;
+	mSeed = seed;
+	mRolloutCount = std::max( rolloutCount, 0 );
+	mNextRolloutIndex = 0;
+	mWinningFactionIndices.assign( mRolloutCount, GameSnapshot::NO_FACTION );
+
+	// Play out the rollouts on all workers (don't start more workers than there are rollouts).
+	int workerCount = std::max( std::min( mWorkerCount, mRolloutCount ), 1 );
+
+	WorkerGroup::Run( workerCount, [this]( int )
+	{
+		RunWorker();
+	});
+
+	// Add up the results in playout order.
+	result.winCounts.assign( snapshot.GetFactionCount(), 0 );
+	result.drawCount = 0;
+	result.rolloutCount = mRolloutCount;
+
+	for( auto it = mWinningFactionIndices.begin(); it != mWinningFactionIndices.end(); ++it )
+	{
+		if( *it != GameSnapshot::NO_FACTION )
+		{
+			++result.winCounts[ *it ];
+		}
+		else
+		{
+			++result.drawCount;
+		}
+	}
+
+	mSnapshot = nullptr;
+}
+
+
+int RolloutEngine::PlayOut( GameSnapshot& snapshot, int maxTurnCount )
+{
+	int winningFactionIndex = snapshot.GetWinningFactionIndex();
+
+	for( int i = 0; i < maxTurnCount && winningFactionIndex == GameSnapshot::NO_FACTION; ++i )
+	{
+		// Play turns until only one Faction is left undefeated (or the turn limit is reached).
+		PlayTurn( snapshot );
+		winningFactionIndex = snapshot.GetWinningFactionIndex();
+	}
+
+	return winningFactionIndex;
+}
+
+
+void RolloutEngine::PlayTurn( GameSnapshot& snapshot )
+{
+	int factionIndex = snapshot.GetCurrentFactionIndex();
+
+	for( int i = 0; i < snapshot.GetUnitCount(); ++i )
+	{
+		const GameSnapshot::UnitState& unit = snapshot.GetUnit( i );
+
+		if( unit.isAlive && unit.isActive && unit.ownerIndex == factionIndex )
+		{
+			// Let each of the Faction's Units act.
+			PlayUnit( snapshot, i );
+		}
+	}
+
+	snapshot.NextTurn();
+}
+
+
+void RolloutEngine::PlayUnit( GameSnapshot& snapshot, int unitIndex )
+{
+	// If an enemy is already in range, attack it without moving.
+	int targetIndex = FindBestTarget( snapshot, unitIndex );
+
+	if( targetIndex < 0 )
+	{
+		int enemyIndex = FindNearestEnemy( snapshot, unitIndex );
+
+		if( enemyIndex < 0 )
+		{
+			return;
+		}
+
+		const GameSnapshot::UnitState& unit = snapshot.GetUnit( unitIndex );
+		const GameSnapshot::UnitState& enemy = snapshot.GetUnit( enemyIndex );
+		const Scenario* scenario = snapshot.GetScenario();
+		const UnitType* unitType = scenario->UnitTypes.FindByID( unit.unitTypeID );
+		const int* movementCosts = scenario->GetMovementCostsByTerrainTypeID( unitType->GetMovementType() );
+		const IntRange& attackRange = unitType->GetAttackRange();
+
+		// Step toward the nearest enemy until the Unit runs out of movement or gets in range.
+		int remainingMovement = std::min( unitType->GetMovementRange(), (int) unit.supplies );
+		int pathCost = 0;
+		short tileX = unit.tileX;
+		short tileY = unit.tileY;
+		int distance = ( std::abs( enemy.tileX - tileX ) + std::abs( enemy.tileY - tileY ) );
+
+		while( !attackRange.IsValueInRange( distance ) )
+		{
+			int bestDirectionIndex = -1;
+			int bestDistance = distance;
+			int tieCount = 0;
+
+			for( size_t i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
+			{
+				Vec2s offset = CARDINAL_DIRECTIONS[ i ].GetOffset();
+				short adjacentX = ( tileX + offset.x );
+				short adjacentY = ( tileY + offset.y );
+
+				if( !snapshot.IsValidTilePos( adjacentX, adjacentY ) )
+				{
+					continue;
+				}
+
+				size_t adjacentIndex = snapshot.GetTileIndex( adjacentX, adjacentY );
+				short adjacentTerrainTypeID = snapshot.GetTerrainTypeID( adjacentIndex );
+
+				if( adjacentTerrainTypeID < 0 || snapshot.GetTileUnitIndex( adjacentIndex ) != GameSnapshot::NO_UNIT )
+				{
+					// Units can't move through other Units in playouts.
+					continue;
+				}
+
+				int costToEnterAdjacent = movementCosts[ adjacentTerrainTypeID ];
+
+				if( costToEnterAdjacent < 0 || costToEnterAdjacent > remainingMovement )
+				{
+					continue;
+				}
+
+				int adjacentDistance = ( std::abs( enemy.tileX - adjacentX ) + std::abs( enemy.tileY - adjacentY ) );
+
+				if( adjacentDistance < bestDistance )
+				{
+					bestDirectionIndex = (int) i;
+					bestDistance = adjacentDistance;
+					tieCount = 1;
+				}
+				else if( adjacentDistance == bestDistance && bestDirectionIndex > -1 && snapshot.GetRandom().RandomInRange( 0, tieCount++ ) == 0 )
+				{
+					// Break ties randomly so playouts don't all take the same route.
+					bestDirectionIndex = (int) i;
+				}
+			}
+
+			if( bestDirectionIndex < 0 )
+			{
+				// If no step gets the Unit closer, stop here.
+				break;
+			}
+
+			// Take the step.
+			Vec2s offset = CARDINAL_DIRECTIONS[ bestDirectionIndex ].GetOffset();
+			tileX += offset.x;
+			tileY += offset.y;
+
+			int costToEnter = movementCosts[ snapshot.GetTerrainTypeID( snapshot.GetTileIndex( tileX, tileY ) ) ];
+			remainingMovement -= costToEnter;
+			pathCost += costToEnter;
+			distance = bestDistance;
+		}
+
+		if( pathCost > 0 )
+		{
+			snapshot.MoveUnit( unitIndex, tileX, tileY, pathCost );
+		}
+
+		// Attack from the new tile (if possible).
+		targetIndex = FindBestTarget( snapshot, unitIndex );
+	}
+
+	if( targetIndex > -1 )
+	{
+		snapshot.Attack( unitIndex, targetIndex );
+	}
+}
+
+
+int RolloutEngine::FindBestTarget( const GameSnapshot& snapshot, int unitIndex )
+{
+	const GameSnapshot::UnitState& unit = snapshot.GetUnit( unitIndex );
+	int bestTargetIndex = -1;
+	int bestDamagePercentage = 0;
+
+	for( int i = 0; i < snapshot.GetUnitCount(); ++i )
+	{
+		if( snapshot.GetUnit( i ).ownerIndex == unit.ownerIndex || !snapshot.CanAttack( unitIndex, i ) )
+		{
+			continue;
+		}
+
+		int damagePercentage = snapshot.CalculateDamagePercentage( unitIndex, i, snapshot.GetBestAvailableWeaponAgainst( unitIndex, i ) );
+
+		if( damagePercentage > bestDamagePercentage )
+		{
+			// Attack the target that takes the most damage.
+			bestTargetIndex = i;
+			bestDamagePercentage = damagePercentage;
+		}
+	}
+
+	return bestTargetIndex;
+}
+
+
+int RolloutEngine::FindNearestEnemy( const GameSnapshot& snapshot, int unitIndex )
+{
+	const GameSnapshot::UnitState& unit = snapshot.GetUnit( unitIndex );
+	int nearestEnemyIndex = -1;
+	int nearestDistance = 0;
+
+	for( int i = 0; i < snapshot.GetUnitCount(); ++i )
+	{
+		const GameSnapshot::UnitState& other = snapshot.GetUnit( i );
+
+		if( !other.isAlive || other.ownerIndex == unit.ownerIndex )
+		{
+			continue;
+		}
+
+		int distance = ( std::abs( other.tileX - unit.tileX ) + std::abs( other.tileY - unit.tileY ) );
+
+		if( nearestEnemyIndex < 0 || distance < nearestDistance )
+		{
+			nearestEnemyIndex = i;
+			nearestDistance = distance;
+		}
+	}
+
+	return nearestEnemyIndex;
+}
+
+
+void RolloutEngine::RunWorker()
+{
+	// Reuse one copy of the snapshot for all playouts on this worker.
+	GameSnapshot snapshot;
+
+	while( true )
+	{
+		// Claim the next playout.
+		int rolloutIndex = __sync_fetch_and_add( &mNextRolloutIndex, 1 );
+
+		if( rolloutIndex >= mRolloutCount )
+		{
+			break;
+		}
+
+		// Give each playout its own random stream so the results don't depend on which worker ran it.
+		snapshot = *mSnapshot;
+		snapshot.GetRandom().Seed( mSeed, (uint64) rolloutIndex );
+
+		mWinningFactionIndices[ rolloutIndex ] = (short) PlayOut( snapshot, mMaxTurnCount );
+	}
+}
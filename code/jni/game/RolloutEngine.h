@@ -0,0 +1,78 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Estimates the outcome of a Game by playing it out many times from a GameSnapshot. Each playout copies the
+	 * snapshot and plays every turn with a fast greedy policy (attack the best target in range, otherwise step toward
+	 * the nearest enemy and attack if possible). Playouts are split between worker threads, and playout N always
+	 * uses random stream N of the seed, so the results only depend on the seed (not on the number of workers).
+	 */
+	class RolloutEngine
+	{
+	public:
+		static const int DEFAULT_MAX_TURN_COUNT = 30;
+		static const int MAX_WORKER_COUNT = 4;
+
+		/**
+		 * The outcome of a batch of playouts.
+		 */
+		struct Result
+		{
+			std::vector< int > winCounts;
+			int drawCount;
+			int rolloutCount;
+
+			float GetWinRate( int factionIndex ) const;
+		};
+
+		RolloutEngine();
+		~RolloutEngine();
+
+		void SetWorkerCount( int workerCount );
+		int GetWorkerCount() const;
+		void SetMaxTurnCount( int maxTurnCount );
+		int GetMaxTurnCount() const;
+
+		void Run( const GameSnapshot& snapshot, int rolloutCount, uint64 seed, Result& result );
+
+		static int PlayOut( GameSnapshot& snapshot, int maxTurnCount );
+		static void PlayTurn( GameSnapshot& snapshot );
+
+	private:
+		RolloutEngine( const RolloutEngine& other );
+		void operator=( const RolloutEngine& other );
+
+		static void PlayUnit( GameSnapshot& snapshot, int unitIndex );
+		static int FindBestTarget( const GameSnapshot& snapshot, int unitIndex );
+		static int FindNearestEnemy( const GameSnapshot& snapshot, int unitIndex );
+
+		void RunWorker();
+
+		int mWorkerCount;
+		int mMaxTurnCount;
+		const GameSnapshot* mSnapshot;
+		uint64 mSeed;
+		int mRolloutCount;
+		volatile int mNextRolloutIndex;
+		std::vector< short > mWinningFactionIndices;
+	};
+
+
+	inline float RolloutEngine::Result::GetWinRate( int factionIndex ) const
+	{
+		return ( rolloutCount > 0 ? ( (float) winCounts[ factionIndex ] / rolloutCount ) : 0.0f );
+	}
+
+
+	inline int RolloutEngine::GetWorkerCount() const
+	{
+		return mWorkerCount;
+	}
+
+
+	inline int RolloutEngine::GetMaxTurnCount() const
+	{
+		return mMaxTurnCount;
+	}
+}
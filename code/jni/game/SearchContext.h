@@ -0,0 +1,227 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Holds the scratch data for a single search over a Map. Each thread that searches a Map should use its own
+	 * SearchContext, which allows many searches to run at the same time as long as the Map is not modified.
+	 */
+	class SearchContext
+	{
+	public:
+		typedef IndexedMinHeap< int > OpenList;
+
+		enum TileOccupancy
+		{
+			OCCUPANCY_NONE,
+			OCCUPANCY_FRIENDLY,
+			OCCUPANCY_ENEMY
+		};
+
+		SearchContext();
+		~SearchContext();
+
+		void BeginSearch( size_t tileCount );
+
+		void SetSource( const Unit* unit, const Vec2s& originPos, int movementRange, unsigned int mapRevision );
+		bool IsFromSource( const Unit* unit, const Vec2s& originPos, int movementRange, unsigned int mapRevision ) const;
+		Vec2s GetOriginPos() const;
+
+		OpenList& GetOpenList();
+
+		void Close( size_t tileIndex );
+		bool IsClosed( size_t tileIndex ) const;
+
+		void SetPreviousTileDirection( size_t tileIndex, PrimaryDirection direction );
+		PrimaryDirection GetPreviousTileDirection( size_t tileIndex ) const;
+
+		void SetBestTotalCostToEnter( size_t tileIndex, int totalCostToEnter );
+		int GetBestTotalCostToEnter( size_t tileIndex ) const;
+
+		void SetRemainingSupplies( size_t tileIndex, int remainingSupplies );
+		int GetRemainingSupplies( size_t tileIndex ) const;
+
+		void SetTileOccupancy( size_t tileIndex, TileOccupancy occupancy );
+		TileOccupancy GetTileOccupancy( size_t tileIndex ) const;
+
+		void AddReachedTile( size_t tileIndex );
+		const TileIndexSet& GetReachedTiles() const;
+
+		int GetExpandedTileCount() const;
+
+	private:
+		SearchContext( const SearchContext& other );
+		void operator=( const SearchContext& other );
+
+		int mSearchIndex;
+		int mExpandedTileCount;
+		const Unit* mUnit;
+		Vec2s mOriginPos;
+		int mMovementRange;
+		unsigned int mMapRevision;
+		OpenList mOpenList;
+		std::vector< PrimaryDirection > mPreviousTileDirections;
+		std::vector< int > mBestTotalCostsToEnter;
+		std::vector< int > mRemainingSupplies;
+		std::vector< int > mClosedSearchIndices;
+		std::vector< unsigned char > mTileOccupancy;
+		std::vector< size_t > mOccupiedTileIndices;
+		TileIndexSet mReachedTiles;
+	};
+
+
+	inline SearchContext::SearchContext() :
+		mSearchIndex( 0 ),
+		mExpandedTileCount( 0 ),
+		mUnit( nullptr ),
+		mMovementRange( 0 ),
+		mMapRevision( 0 )
+	{ }
+
+
+	inline SearchContext::~SearchContext() { }
+
+
+	inline void SearchContext::BeginSearch( size_t tileCount )
+	{
+		if( mClosedSearchIndices.size() < tileCount || mSearchIndex == Mathi::MAX_REAL )
+		{
+			// If the search needs more nodes than before (or the search index is about to wrap), reset all scratch data.
+			// Smaller searches reuse the larger storage, so searches of different sizes can share a context.
+			mOpenList.resize( tileCount );
+			mPreviousTileDirections.assign( tileCount, PrimaryDirection::NONE );
+			mBestTotalCostsToEnter.assign( tileCount, 0 );
+			mRemainingSupplies.assign( tileCount, 0 );
+			mClosedSearchIndices.assign( tileCount, -1 );
+			mTileOccupancy.assign( tileCount, OCCUPANCY_NONE );
+			mSearchIndex = 0;
+		}
+		else
+		{
+			// Otherwise, just clear the open list and start a new search.
+			mOpenList.clear();
+			++mSearchIndex;
+
+			for( auto it = mOccupiedTileIndices.begin(); it != mOccupiedTileIndices.end(); ++it )
+			{
+				// Clear the occupancy of the last search (only the tiles that were marked).
+				mTileOccupancy[ *it ] = OCCUPANCY_NONE;
+			}
+		}
+
+		mOccupiedTileIndices.clear();
+
+		// Clear the results of the last search.
+		mReachedTiles.Reset( tileCount );
+		mExpandedTileCount = 0;
+		mUnit = nullptr;
+	}
+
+
+	inline void SearchContext::SetSource( const Unit* unit, const Vec2s& originPos, int movementRange, unsigned int mapRevision )
+	{
+		// Remember what the search was run for, so the results can be reused until something changes.
+		mUnit = unit;
+		mOriginPos = originPos;
+		mMovementRange = movementRange;
+		mMapRevision = mapRevision;
+	}
+
+
+	inline bool SearchContext::IsFromSource( const Unit* unit, const Vec2s& originPos, int movementRange, unsigned int mapRevision ) const
+	{
+		return ( mUnit != nullptr && mUnit == unit && mOriginPos == originPos && mMovementRange == movementRange && mMapRevision == mapRevision );
+	}
+
+
+	inline Vec2s SearchContext::GetOriginPos() const
+	{
+		return mOriginPos;
+	}
+
+
+	inline SearchContext::OpenList& SearchContext::GetOpenList()
+	{
+		return mOpenList;
+	}
+
+
+	inline void SearchContext::Close( size_t tileIndex )
+	{
+		mClosedSearchIndices[ tileIndex ] = mSearchIndex;
+		++mExpandedTileCount;
+	}
+
+
+	inline bool SearchContext::IsClosed( size_t tileIndex ) const
+	{
+		return ( mClosedSearchIndices[ tileIndex ] == mSearchIndex );
+	}
+
+
+	inline void SearchContext::SetPreviousTileDirection( size_t tileIndex, PrimaryDirection direction )
+	{
+		mPreviousTileDirections[ tileIndex ] = direction;
+	}
+
+
+	inline PrimaryDirection SearchContext::GetPreviousTileDirection( size_t tileIndex ) const
+	{
+		return mPreviousTileDirections[ tileIndex ];
+	}
+
+
+	inline void SearchContext::SetBestTotalCostToEnter( size_t tileIndex, int totalCostToEnter )
+	{
+		mBestTotalCostsToEnter[ tileIndex ] = totalCostToEnter;
+	}
+
+
+	inline int SearchContext::GetBestTotalCostToEnter( size_t tileIndex ) const
+	{
+		return mBestTotalCostsToEnter[ tileIndex ];
+	}
+
+
+	inline void SearchContext::SetRemainingSupplies( size_t tileIndex, int remainingSupplies )
+	{
+		mRemainingSupplies[ tileIndex ] = remainingSupplies;
+	}
+
+
+	inline int SearchContext::GetRemainingSupplies( size_t tileIndex ) const
+	{
+		return mRemainingSupplies[ tileIndex ];
+	}
+
+
+	inline void SearchContext::SetTileOccupancy( size_t tileIndex, TileOccupancy occupancy )
+	{
+		mTileOccupancy[ tileIndex ] = (unsigned char) occupancy;
+		mOccupiedTileIndices.push_back( tileIndex );
+	}
+
+
+	inline SearchContext::TileOccupancy SearchContext::GetTileOccupancy( size_t tileIndex ) const
+	{
+		return (TileOccupancy) mTileOccupancy[ tileIndex ];
+	}
+
+
+	inline void SearchContext::AddReachedTile( size_t tileIndex )
+	{
+		mReachedTiles.Add( tileIndex );
+	}
+
+
+	inline const TileIndexSet& SearchContext::GetReachedTiles() const
+	{
+		return mReachedTiles;
+	}
+
+
+	inline int SearchContext::GetExpandedTileCount() const
+	{
+		return mExpandedTileCount;
+	}
+}
@@ -0,0 +1,209 @@
+#include "androidwars_sim.h"
+
+using namespace mage;
+
+
+ThreatMap::ThreatMap() :
+	mMap( nullptr ),
+	mFaction( nullptr )
+{ }
+
+
+ThreatMap::~ThreatMap() { }
+
+
+void ThreatMap::Build( const Map* map, const Faction* faction )
+{
+	assertion( map, "Cannot build ThreatMap for null Map!" );
+
+	// Throw away the previous results.
+	Clear();
+
+	mMap = map;
+	mFaction = faction;
+
+	// Reset the threat count of every tile.
+	mThreatCounts.assign( (size_t) mMap->GetWidth() * (size_t) mMap->GetHeight(), 0 );
+
+	const Map::Units& units = mMap->GetUnits();
+
+	for( auto it = units.begin(); it != units.end(); ++it )
+	{
+		const Unit* unit = *it;
+
+		if( IsThreateningUnit( unit ) && !GetUnitTypeThreat( unit->GetUnitType() ) )
+		{
+			// Create a group for each UnitType that can threaten the Faction.
+			UnitTypeThreat threat;
+			threat.unitType = unit->GetUnitType();
+			mUnitTypeThreats.push_back( threat );
+		}
+	}
+
+	for( auto it = mUnitTypeThreats.begin(); it != mUnitTypeThreats.end(); ++it )
+	{
+		// Find the tiles each group can attack.
+		RebuildUnitTypeThreat( *it );
+	}
+}
+
+
+void ThreatMap::RefreshUnit( const Unit* unit )
+{
+	assertion( mMap, "Cannot refresh ThreatMap that has not been built!" );
+	assertion( mThreatCounts.size() == (size_t) mMap->GetWidth() * (size_t) mMap->GetHeight(), "Cannot refresh ThreatMap because the Map was resized!" );
+
+	UnitTypeThreat* threat = GetUnitTypeThreat( unit->GetUnitType() );
+
+	if( !threat )
+	{
+		if( !IsThreateningUnit( unit ) )
+		{
+			// If the Unit doesn't threaten the Faction and no group exists for its UnitType, it was never counted.
+			return;
+		}
+
+		// If no Units of this type were known yet, create a new group.
+		UnitTypeThreat newThreat;
+		newThreat.unitType = unit->GetUnitType();
+		mUnitTypeThreats.push_back( newThreat );
+		threat = &mUnitTypeThreats.back();
+	}
+
+	// Only the group for the Unit's UnitType needs to be searched again (even if the Unit just left it by dying or
+	// changing owner).
+	RebuildUnitTypeThreat( *threat );
+}
+
+
+void ThreatMap::Clear()
+{
+	mMap = nullptr;
+	mFaction = nullptr;
+	mUnitTypeThreats.clear();
+	mThreatCounts.clear();
+}
+
+
+int ThreatMap::GetThreatCount( const Vec2s& tilePos ) const
+{
+	int result = 0;
+
+	if( mMap && mMap->IsValidTilePos( tilePos ) )
+	{
+		// Return the number of UnitTypes that can attack the tile.
+		result = mThreatCounts[ mMap->GetCompactTileIndex( tilePos ) ];
+	}
+
+	return result;
+}
+
+
+bool ThreatMap::IsThreatened( const Vec2s& tilePos ) const
+{
+	return ( GetThreatCount( tilePos ) > 0 );
+}
+
+
+const Map* ThreatMap::GetMap() const
+{
+	return mMap;
+}
+
+
+const Faction* ThreatMap::GetFaction() const
+{
+	return mFaction;
+}
+
+
+bool ThreatMap::IsThreateningUnit( const Unit* unit ) const
+{
+	// Living Units that belong to other Factions and have weapons threaten the Faction.
+	return ( unit->IsAlive() && unit->GetOwner() != mFaction && unit->GetUnitType()->GetNumWeapons() > 0 );
+}
+
+
+ThreatMap::UnitTypeThreat* ThreatMap::GetUnitTypeThreat( const UnitType* unitType )
+{
+	UnitTypeThreat* result = nullptr;
+
+	for( auto it = mUnitTypeThreats.begin(); it != mUnitTypeThreats.end(); ++it )
+	{
+		if( it->unitType == unitType )
+		{
+			// If a group exists for this UnitType, return it.
+			result = &( *it );
+			break;
+		}
+	}
+
+	return result;
+}
+
+
+void ThreatMap::RebuildUnitTypeThreat( UnitTypeThreat& threat )
+{
+	// Remove the old coverage of the group from the threat counts.
+	for( auto it = threat.coverage.begin(); it != threat.coverage.end(); ++it )
+	{
+		--mThreatCounts[ *it ];
+	}
+
+	size_t tileCount = mThreatCounts.size();
+	threat.coverage.Reset( tileCount );
+
+	// Gather the tiles of all threatening Units of this type.
+	mSources.clear();
+	const Map::Units& units = mMap->GetUnits();
+
+	for( auto it = units.begin(); it != units.end(); ++it )
+	{
+		const Unit* unit = *it;
+
+		if( unit->GetUnitType() == threat.unitType && IsThreateningUnit( unit ) )
+		{
+			Map::SearchSource source;
+			source.tilePos = unit->GetTilePos();
+			source.movementRange = unit->GetMovementRange();
+			mSources.push_back( source );
+		}
+	}
+
+	if( !mSources.empty() )
+	{
+		// Find every tile that any Unit of this type can move to, in a single search.
+		mMap->FindReachableTilesFromSources( threat.unitType->GetMovementType(), mSources, mSearchContext );
+
+		// Expand the reachable tiles by the attack range of the UnitType.
+		const IntRange& attackRange = threat.unitType->GetAttackRange();
+		const TileIndexSet& reachableTiles = mSearchContext.GetReachedTiles();
+
+		for( auto it = reachableTiles.begin(); it != reachableTiles.end(); ++it )
+		{
+			Vec2s tilePos = mMap->GetTilePosFromCompactIndex( *it );
+
+			for( int dy = -attackRange.Max; dy <= attackRange.Max; ++dy )
+			{
+				int remainingRange = ( attackRange.Max - std::abs( dy ) );
+
+				for( int dx = -remainingRange; dx <= remainingRange; ++dx )
+				{
+					Vec2s targetPos( (short) ( tilePos.x + dx ), (short) ( tilePos.y + dy ) );
+
+					if( std::abs( dx ) + std::abs( dy ) >= attackRange.Min && mMap->IsValidTilePos( targetPos ) )
+					{
+						// If the target tile is within the attack range, the group threatens it.
+						threat.coverage.Add( mMap->GetCompactTileIndex( targetPos ) );
+					}
+				}
+			}
+		}
+	}
+
+	// Add the new coverage of the group to the threat counts.
+	for( auto it = threat.coverage.begin(); it != threat.coverage.end(); ++it )
+	{
+		++mThreatCounts[ *it ];
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Tracks which tiles of a Map can be attacked next turn by Units that are not owned by a particular Faction.
+	 * Units are grouped by UnitType and each group is searched in a single pass, so building the ThreatMap costs one
+	 * search per UnitType instead of one search per Unit.
+	 */
+	class ThreatMap
+	{
+	public:
+		ThreatMap();
+		~ThreatMap();
+
+		void Build( const Map* map, const Faction* faction );
+		void RefreshUnit( const Unit* unit );
+		void Clear();
+
+		int GetThreatCount( const Vec2s& tilePos ) const;
+		bool IsThreatened( const Vec2s& tilePos ) const;
+
+		const Map* GetMap() const;
+		const Faction* GetFaction() const;
+
+	private:
+		/**
+		 * The tiles that Units of a single UnitType can attack.
+		 */
+		struct UnitTypeThreat
+		{
+			const UnitType* unitType;
+			TileIndexSet coverage;
+		};
+
+		ThreatMap( const ThreatMap& other );
+		void operator=( const ThreatMap& other );
+
+		bool IsThreateningUnit( const Unit* unit ) const;
+		UnitTypeThreat* GetUnitTypeThreat( const UnitType* unitType );
+		void RebuildUnitTypeThreat( UnitTypeThreat& threat );
+
+		const Map* mMap;
+		const Faction* mFaction;
+		std::vector< UnitTypeThreat > mUnitTypeThreats;
+		std::vector< int > mThreatCounts;
+		Map::SearchSources mSources;
+		SearchContext mSearchContext;
+	};
+}
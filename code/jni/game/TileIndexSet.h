@@ -0,0 +1,133 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * A set of compact tile indices stored as a flat list (for iteration) plus a bitset (for constant time membership
+	 * tests). Reset() reuses the existing storage, so a TileIndexSet can be kept around and refilled without allocating.
+	 */
+	class TileIndexSet
+	{
+	public:
+		typedef std::vector< size_t > TileIndices;
+		typedef TileIndices::const_iterator const_iterator;
+
+		TileIndexSet();
+		~TileIndexSet();
+
+		void Reset( size_t tileCount );
+		void Clear();
+
+		void Add( size_t tileIndex );
+		bool Contains( size_t tileIndex ) const;
+
+		size_t GetSize() const;
+		bool IsEmpty() const;
+		size_t GetTileIndex( size_t index ) const;
+		const TileIndices& GetTileIndices() const;
+
+		const_iterator begin() const;
+		const_iterator end() const;
+
+	private:
+		static const size_t BITS_PER_WORD = 32;
+
+		TileIndices mTileIndices;
+		std::vector< uint32 > mMembershipBits;
+	};
+
+
+	inline TileIndexSet::TileIndexSet() { }
+
+
+	inline TileIndexSet::~TileIndexSet() { }
+
+
+	inline void TileIndexSet::Reset( size_t tileCount )
+	{
+		size_t wordCount = ( ( tileCount + BITS_PER_WORD - 1 ) / BITS_PER_WORD );
+
+		if( mMembershipBits.size() != wordCount )
+		{
+			// If the number of tiles changed, reallocate the bitset.
+			mTileIndices.clear();
+			mMembershipBits.assign( wordCount, 0 );
+		}
+		else
+		{
+			// Otherwise, just clear the current contents.
+			Clear();
+		}
+	}
+
+
+	inline void TileIndexSet::Clear()
+	{
+		for( auto it = mTileIndices.begin(); it != mTileIndices.end(); ++it )
+		{
+			// Only clear the words that are in use, so clearing is proportional to the size of the set.
+			mMembershipBits[ *it / BITS_PER_WORD ] = 0;
+		}
+
+		mTileIndices.clear();
+	}
+
+
+	inline void TileIndexSet::Add( size_t tileIndex )
+	{
+		assertion( tileIndex / BITS_PER_WORD < mMembershipBits.size(), "Cannot add tile index %d to TileIndexSet because it is out of bounds!", tileIndex );
+
+		uint32& word = mMembershipBits[ tileIndex / BITS_PER_WORD ];
+		uint32 bit = ( 1u << ( tileIndex % BITS_PER_WORD ) );
+
+		if( ( word & bit ) == 0 )
+		{
+			// If the tile isn't already in the set, add it.
+			word |= bit;
+			mTileIndices.push_back( tileIndex );
+		}
+	}
+
+
+	inline bool TileIndexSet::Contains( size_t tileIndex ) const
+	{
+		size_t wordIndex = ( tileIndex / BITS_PER_WORD );
+		return ( wordIndex < mMembershipBits.size() && ( mMembershipBits[ wordIndex ] & ( 1u << ( tileIndex % BITS_PER_WORD ) ) ) != 0 );
+	}
+
+
+	inline size_t TileIndexSet::GetSize() const
+	{
+		return mTileIndices.size();
+	}
+
+
+	inline bool TileIndexSet::IsEmpty() const
+	{
+		return mTileIndices.empty();
+	}
+
+
+	inline size_t TileIndexSet::GetTileIndex( size_t index ) const
+	{
+		return mTileIndices[ index ];
+	}
+
+
+	inline const TileIndexSet::TileIndices& TileIndexSet::GetTileIndices() const
+	{
+		return mTileIndices;
+	}
+
+
+	inline TileIndexSet::const_iterator TileIndexSet::begin() const
+	{
+		return mTileIndices.begin();
+	}
+
+
+	inline TileIndexSet::const_iterator TileIndexSet::end() const
+	{
+		return mTileIndices.end();
+	}
+}
@@ -1,12 +1,88 @@
-#include "androidwars.h"
+#include "androidwars_sim.h"
 
 using namespace mage;
 
 
 const int Unit::MAX_HEALTH;
+const int Unit::REPAIR_AMOUNT;
 
 
-MAGE_IMPLEMENT_RTTI( MapObject, Unit );
+MAGE_IMPLEMENT_RTTI_BASE( Unit );
+
+
+bool Unit::CanFireWeaponWithAmmo( const Weapon& weapon, int ammo )
+{
+	return ( !weapon.ConsumesAmmo() || ( weapon.GetAmmoPerShot() <= ammo ) );
+}
+
+
+int Unit::ChooseBestWeaponAgainst( const Scenario* scenario, const UnitType* unitType, int ammo, const UnitType* targetType )
+{
+	int bestDamagePercentage = 0;
+	int bestWeaponIndex = -1;
+
+	for( int i = 0; i < unitType->GetNumWeapons(); ++i )
+	{
+		// Check each weapon to see which one is the best.
+		int damagePercentage = scenario->GetDamagePercentage( unitType, i, targetType );
+
+		if( damagePercentage > bestDamagePercentage && CanFireWeaponWithAmmo( unitType->GetWeaponByIndex( i ), ammo ) )
+		{
+			// If this weapon can fire at the target and is better than any other weapon (so far), save it as the best choice.
+			bestDamagePercentage = damagePercentage;
+			bestWeaponIndex = i;
+		}
+	}
+
+	return bestWeaponIndex;
+}
+
+
+float Unit::CalculateDefenseBonus( const TerrainType* terrainType, int health )
+{
+	// The cover of the tile protects healthy Units more than damaged ones.
+	float coverBonusScale = ( terrainType->GetCoverBonus() * 0.1f );
+	float healthScale = ( (float) health / MAX_HEALTH );
+	return Mathf::Clamp( coverBonusScale * healthScale, 0.0f, 1.0f );
+}
+
+
+int Unit::ScaleDamagePercentage( int baseDamagePercentage, int health, float targetDefenseBonus )
+{
+	// Scale the damage by the health of the attacker and the defense bonus of the target.
+	float healthScale = ( (float) health / MAX_HEALTH );
+	float targetDefenseScale = Mathf::Clamp( 1.0f - targetDefenseBonus, 0.0f, 1.0f );
+	return (int) ( baseDamagePercentage * healthScale * targetDefenseScale );
+}
+
+
+int Unit::RollDamage( int damagePercentage, RandomStream& random )
+{
+	// Separate the percentage into the guaranteed damage amount and the amount that
+	// will contribute to the the extra damage roll.
+	int guaranteedDamage = ( damagePercentage / 10 );
+	int extraDamageChance = ( damagePercentage % 10 );
+
+	LogDebug( "Guaranteed damage: %d", guaranteedDamage );
+	LogDebug( "Extra damage chance: %d in 10", extraDamageChance );
+
+	// Apply the guaranteed damage amount.
+	int totalDamage = guaranteedDamage;
+
+	// Roll a 10-sided die to see if extra damage should be applied.
+	int extraDamageRoll = random.RandomInRange( 1, 10 );
+	bool success = ( extraDamageChance >= extraDamageRoll );
+	LogDebug( "Extra damage roll %s! (Rolled a %d, needed %d or lower to pass.)", ( success ? "SUCCEEDED" : "FAILED" ), extraDamageRoll, extraDamageChance );
+
+	if( success )
+	{
+		// Add one point of extra damage if the extra damage roll succeeded.
+		++totalDamage;
+	}
+
+	LogDebug( "TOTAL DAMAGE: %d", totalDamage );
+	return totalDamage;
+}
 
 
 Unit::Unit() :
@@ -48,6 +124,9 @@ void Unit::Init( Map* map, const Map::Iterator& tile )
 	mTile = tile;
 	assertion( mTile.IsValid(), "Cannot initialize Unit at invalid Map tile (%d,%d)!", mTile.GetX(), mTile.GetY() );
 	assertion( mTile->IsEmpty(), "Cannot initialize Unit at Map tile (%d,%d) because a Unit already exists at that location!", mTile.GetX(), mTile.GetY() );
+
+	// Let the owner keep track of this Unit.
+	mOwner->UnitGained( this );
 }
 
 
@@ -72,20 +151,6 @@ void Unit::Destroy()
 }
 
 
-void Unit::OnTurnStart( int turnIndex )
-{
-	// Consume supplies.
-	MovementType* movementType = GetMovementType();
-	ConsumeSupplies( movementType->GetSuppliesConsumedPerTurn() );
-
-	if( movementType->RequiresSuppliesToSurvive() && !HasSupplies() )
-	{
-		// If the Unit runs out of supplies and it needs them to survive, kill it.
-		Die();
-	}
-}
-
-
 void Unit::OnTurnEnd( int turnIndex )
 {
 	// Reactivate this Unit.
@@ -326,64 +391,43 @@ bool Unit::IsOwnedBy( Faction* faction ) const
 
 bool Unit::CanAttack( const Unit& target ) const
 {
-	DebugPrintf( "Checking whether %s can attack %s...", ToString().c_str(), target.ToString().c_str() );
+	LogTrace( "Checking whether %s can attack %s...", ToString().c_str(), target.ToString().c_str() );
 
 	// Make sure this Unit is still alive.
 	bool isAlive = IsAlive();
-	DebugPrintf( "%s is %s.", ToString().c_str(), ( isAlive ? "ALIVE" : "DEAD" ) );
+	LogTrace( "%s is %s.", ToString().c_str(), ( isAlive ? "ALIVE" : "DEAD" ) );
 
 	// Check whether the target is in range.
 	bool isInRange = IsInRange( target );
-	DebugPrintf( "%s %s in range.", target.ToString().c_str(), ( isInRange ? "IS" : "IS NOT" ) );
+	LogTrace( "%s %s in range.", target.ToString().c_str(), ( isInRange ? "IS" : "IS NOT" ) );
 
 	// Check whether this Unit can target the other Unit.
 	bool canTarget = CanTarget( target );
-	DebugPrintf( "%s %s target %s.", ToString().c_str(), ( isInRange ? "CAN" : "CANNOT" ), target.ToString().c_str() );
+	LogTrace( "%s %s target %s.", ToString().c_str(), ( isInRange ? "CAN" : "CANNOT" ), target.ToString().c_str() );
 
 	bool result = ( isAlive && isInRange && canTarget );
-	DebugPrintf( "RESULT: %s %s attack %s.", ToString().c_str(), ( result ? "CAN" : "CANNOT" ), target.ToString().c_str() );
+	LogTrace( "RESULT: %s %s attack %s.", ToString().c_str(), ( result ? "CAN" : "CANNOT" ), target.ToString().c_str() );
 
 	return result;
 }
 
 
-void Unit::Attack( Unit& target )
+void Unit::Attack( Unit& target, RandomStream& random )
 {
-	DebugPrintf( "%s attacks %s.", ToString().c_str(), target.ToString().c_str() );
+	LogDebug( "%s attacks %s.", ToString().c_str(), target.ToString().c_str() );
 
 	// Get the best weapon to use against the target.
 	int bestWeaponIndex = GetBestAvailableWeaponAgainst( target );
 	assertion( bestWeaponIndex > -1, "Cannot calculate damage: No weapon can currently target that Unit!" );
 
-	const Weapon bestWeapon = mUnitType->GetWeaponByIndex( bestWeaponIndex );
-	DebugPrintf( "Best weapon: %d (%s)", bestWeaponIndex, bestWeapon.GetName().GetCString() );
+	const Weapon& bestWeapon = mUnitType->GetWeaponByIndex( bestWeaponIndex );
+	LogDebug( "Best weapon: %d (%s)", bestWeaponIndex, bestWeapon.GetName().GetCString() );
 
 	// Calculate damage percentage (before randomness).
 	int damagePercentage = CalculateDamagePercentage( target, bestWeaponIndex );
 
-	// Separate the percentage into the guaranteed damage amount and the amount that
-	// will contribute to the the extra damage roll.
-	int guaranteedDamage = ( damagePercentage / 10 );
-	int extraDamageChance = ( damagePercentage % 10 );
-
-	DebugPrintf( "Guaranteed damage: %d", guaranteedDamage );
-	DebugPrintf( "Extra damage chance: %d in 10", extraDamageChance );
-
-	// Apply the guaranteed damage amount.
-	int totalDamage = guaranteedDamage;
-
-	// Roll a 10-sided die to see if extra damage should be applied.
-	int extraDamageRoll = RNG::RandomInRange( 1, 10 );
-	bool success = ( extraDamageChance >= extraDamageRoll );
-	DebugPrintf( "Extra damage roll %s! (Rolled a %d, needed %d or lower to pass.)", ( success ? "SUCCEEDED" : "FAILED" ), extraDamageRoll, extraDamageChance );
-
-	if( success )
-	{
-		// Add one point of extra damage if the extra damage roll succeeded.
-		++totalDamage;
-	}
-
-	DebugPrintf( "TOTAL DAMAGE: %d", totalDamage );
+	// Roll for the amount of damage to apply.
+	int totalDamage = RollDamage( damagePercentage, random );
 
 	// Apply the damage to the target Unit.
 	target.TakeDamage( totalDamage, this );
@@ -393,7 +437,7 @@ void Unit::Attack( Unit& target )
 		// Consume ammo equal to the amount that the weapon uses per shot.
 		int ammoConsumed = bestWeapon.GetAmmoPerShot();
 		ConsumeAmmo( ammoConsumed );
-		DebugPrintf( "Weapon consumed %d ammo. (%d ammo remaining)", ammoConsumed, mAmmo );
+		LogDebug( "Weapon consumed %d ammo. (%d ammo remaining)", ammoConsumed, mAmmo );
 	}
 }
 
@@ -405,27 +449,23 @@ int Unit::CalculateDamagePercentage( const Unit& target, int weaponIndex ) const
 	// Get the best weapon to use against the target.
 	const Weapon& weapon = mUnitType->GetWeaponByIndex( weaponIndex );
 
-	DebugPrintf( "Calculating damage of %s against %s with weapon %d (%s)...", ToString().c_str(), target.ToString().c_str(),
+	LogTrace( "Calculating damage of %s against %s with weapon %d (%s)...", ToString().c_str(), target.ToString().c_str(),
 				 weaponIndex, weapon.GetName().GetCString() );
 
 	// Get the base amount of damage to apply.
-	int baseDamagePercentage = weapon.GetDamagePercentageAgainstUnitType( target.GetUnitType() );
+	int baseDamagePercentage = mMap->GetScenario()->GetDamagePercentage( mUnitType, weaponIndex, target.GetUnitType() );
 	assertion( baseDamagePercentage > 0, "Cannot calculate damage: weapon cannot target Unit!" );
 
-	DebugPrintf( "Base damage percentage: %d%%", baseDamagePercentage );
-
-	// Scale the damage amount based on the current health of this Unit.
-	float healthScale = GetHealthScale();
-	DebugPrintf( "Health scaling factor: %f", healthScale );
+	LogTrace( "Base damage percentage: %d%%", baseDamagePercentage );
 
-	// Scale the damage amount based on the target's defense bonus.
+	// Scale the damage amount based on the current health of this Unit and the target's defense bonus.
 	float targetDefenseBonus = target.GetDefenseBonus();
-	float targetDefenseScale = Mathf::Clamp( 1.0f - targetDefenseBonus, 0.0f, 1.0f );
-	DebugPrintf( "Target defense bonus: %f (%f x damage)", targetDefenseBonus, targetDefenseScale );
+	LogTrace( "Health scaling factor: %f", GetHealthScale() );
+	LogTrace( "Target defense bonus: %f", targetDefenseBonus );
 
 	// Calculate idealized damage amount.
-	result = (int) ( baseDamagePercentage * healthScale * targetDefenseScale );
-	DebugPrintf( "TOTAL DAMAGE: %d (%d x %f x %f)", result, baseDamagePercentage, healthScale, targetDefenseScale );
+	result = ScaleDamagePercentage( baseDamagePercentage, mHealth, targetDefenseBonus );
+	LogTrace( "TOTAL DAMAGE: %d", result );
 
 	return result;
 }
@@ -435,20 +475,15 @@ float Unit::GetDefenseBonus() const
 {
 	float result;
 
-	DebugPrintf( "Calculating defense bonus for %s...", ToString().c_str() );
+	LogTrace( "Calculating defense bonus for %s...", ToString().c_str() );
 
-	// Get the defensive bonus supplied by the current tile.
+	// Get the defensive bonus supplied by the current tile, scaled by the Unit's current health.
 	TerrainType* terrainType = mTile->GetTerrainType();
-	int coverBonus = terrainType->GetCoverBonus();
-	float coverBonusScale = ( coverBonus * 0.1f );
-	DebugPrintf( "Cover bonus: %d (%f)", coverBonus, coverBonusScale );
+	LogTrace( "Cover bonus: %d", terrainType->GetCoverBonus() );
+	LogTrace( "Health scale: %f x cover bonus", GetHealthScale() );
 
-	// Scale the cover bonus by the Unit's current health.
-	float healthScale = GetHealthScale();
-	DebugPrintf( "Health scale: %f x cover bonus", healthScale );
-
-	result = Mathf::Clamp( coverBonusScale * healthScale, 0.0f, 1.0f );
-	DebugPrintf( "TOTAL DEFENSE BONUS: %f (%f x %f)", result, healthScale, coverBonusScale );
+	result = CalculateDefenseBonus( terrainType, mHealth );
+	LogTrace( "TOTAL DEFENSE BONUS: %f", result );
 
 	return result;
 }
@@ -479,7 +514,7 @@ bool Unit::IsInRangeFromTile( const Unit& target, const Map::ConstIterator& tile
 
 	// Determine whether this Unit is in range.
 	bool isInRange = range.IsValueInRange( distanceToTarget );
-	DebugPrintf( "%s %s in range of %s from tile (%d,%d).", target.ToString().c_str(), ( isInRange ? "is" : "is NOT" ), ToString().c_str(), tile.GetX(), tile.GetY() );
+	LogTrace( "%s %s in range of %s from tile (%d,%d).", target.ToString().c_str(), ( isInRange ? "is" : "is NOT" ), ToString().c_str(), tile.GetX(), tile.GetY() );
 
 	return isInRange;
 }
@@ -493,8 +528,7 @@ int Unit::GetDistanceToUnit( const Unit& target ) const
 
 bool Unit::CanFireWeapon( int weaponIndex ) const
 {
-	Weapon& weapon = mUnitType->GetWeaponByIndex( weaponIndex );
-	return ( !weapon.ConsumesAmmo() || ( weapon.GetAmmoPerShot() <= mAmmo ) );
+	return CanFireWeaponWithAmmo( mUnitType->GetWeaponByIndex( weaponIndex ), mAmmo );
 }
 
 
@@ -508,40 +542,17 @@ int Unit::GetBestAvailableWeaponAgainst( const UnitType* unitType ) const
 {
 	assertion( unitType, "Cannot get best available weapon against NULL UnitType!" );
 
-	int bestDamagePercentage = 0;
-	int bestWeaponIndex = -1;
-
-	DebugPrintf( "Choosing best weapon for %s against %s...", ToString().c_str(), unitType->ToString() );
-
-	for( int i = 0; i < mUnitType->GetNumWeapons(); ++i )
-	{
-		// Check each weapon to see which one is the best.
-		const Weapon& weapon = mUnitType->GetWeaponByIndex( i );
-		int damagePercentage = weapon.GetDamagePercentageAgainstUnitType( unitType );
-
-		bool isBestChoice = ( damagePercentage > bestDamagePercentage );
-		bool canFire = CanFireWeapon( i );
-		bool canTarget = weapon.CanTargetUnitType( unitType );
-
-		if( canFire && canTarget && isBestChoice )
-		{
-			// If this weapon can fire at the enemy and is better than any other weapon (so far),
-			// save it as the best choice.
-			bestDamagePercentage = damagePercentage;
-			bestWeaponIndex = i;
-		}
+	LogTrace( "Choosing best weapon for %s against %s...", ToString().c_str(), unitType->ToString() );
 
-		DebugPrintf( "Weapon %d (%s) %s fire at a %s (%d%% damage) %s %s currently fire", i, weapon.GetName().GetCString(), ( canTarget ? "CAN" : "CANNOT" ),
-					 unitType->ToString(), damagePercentage, ( canTarget == canFire ? "and" : "but" ), ( canFire ? "CAN" : "CANNOT" ) );
-	}
+	int bestWeaponIndex = ChooseBestWeaponAgainst( mMap->GetScenario(), mUnitType, mAmmo, unitType );
 
 	if( bestWeaponIndex > -1 )
 	{
-		DebugPrintf( "BEST CHOICE: Weapon %d (%s)", bestWeaponIndex, mUnitType->GetWeaponByIndex( bestWeaponIndex ).GetName().GetCString() );
+		LogTrace( "BEST CHOICE: Weapon %d (%s)", bestWeaponIndex, mUnitType->GetWeaponByIndex( bestWeaponIndex ).GetName().GetCString() );
 	}
 	else
 	{
-		DebugPrintf( "NO WEAPON AVAILABLE!" );
+		LogTrace( "NO WEAPON AVAILABLE!" );
 	}
 
 	return bestWeaponIndex;
@@ -589,6 +600,9 @@ void Unit::Die()
 		// Mark the Unit as dead.
 		mIsAlive = false;
 
+		// Let the owner keep track of how many of its Units are alive.
+		mOwner->UnitDied( this );
+
 		// Run the death event.
 		OnDeath.Invoke();
 
@@ -655,7 +669,7 @@ bool Unit::HasAmmo() const
 void Unit::SetSupplies( int supplies )
 {
 	mSupplies = Mathi::Clamp( supplies, 0, mUnitType->GetMaxSupplies() );
-	DebugPrintf( "Unit now has %d supplies.", mSupplies );
+	LogTrace( "Unit now has %d supplies.", mSupplies );
 }
 
 
@@ -667,7 +681,7 @@ void Unit::ResetSupplies()
 
 void Unit::ConsumeSupplies( int supplies )
 {
-	DebugPrintf( "Consuming %d supplies from Unit.", supplies );
+	LogTrace( "Consuming %d supplies from Unit.", supplies );
 	SetSupplies( mSupplies - supplies );
 }
 
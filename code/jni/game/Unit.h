@@ -13,6 +13,13 @@ namespace mage
 		typedef Delegate< const Map::Iterator& > OnTileChangedDelegate;
 
 		static const int MAX_HEALTH = 10;
+		static const int REPAIR_AMOUNT = 2;
+
+		static bool CanFireWeaponWithAmmo( const Weapon& weapon, int ammo );
+		static int ChooseBestWeaponAgainst( const Scenario* scenario, const UnitType* unitType, int ammo, const UnitType* targetType );
+		static float CalculateDefenseBonus( const TerrainType* terrainType, int health );
+		static int ScaleDamagePercentage( int baseDamagePercentage, int health, float targetDefenseBonus );
+		static int RollDamage( int damagePercentage, RandomStream& random );
 
 		Unit();
 		virtual ~Unit();
@@ -44,7 +51,7 @@ namespace mage
 		bool IsOwnedBy( Faction* faction ) const;
 
 		bool CanAttack( const Unit& target ) const;
-		void Attack( Unit& target );
+		void Attack( Unit& target, RandomStream& random );
 		int CalculateDamagePercentage( const Unit& target, int weaponIndex ) const;
 		float GetDefenseBonus() const;
 		bool CanTarget( const Unit& target ) const;
@@ -89,7 +96,6 @@ namespace mage
 		void Init( Map* map, const Map::Iterator& tile );
 		void Destroy();
 
-		void OnTurnStart( int turnIndex );
 		void OnTurnEnd( int turnIndex );
 
 		void SetTile( Map::Iterator tile );
@@ -109,6 +115,7 @@ namespace mage
 		Event< const Map::Iterator& > OnTeleport;
 		Event< const Path& > OnMove;
 		Event< int, Unit* > OnTakeDamage;
+		Event<> OnStatsChanged;
 		Event<> OnDeath;
 		Event<> OnDestroyed;
 
@@ -30,7 +30,7 @@ namespace mage
 	};
 
 }
-#	ifdef ANDROID
+#	if defined( ANDROID ) || defined( __GNUC__ )
 #		define assertion( condition, ... )											\
 			mage::Assertion( condition, __FILE__, __LINE__, __VA_ARGS__ )
 #	else
@@ -38,13 +38,13 @@ namespace mage
 			mage::Assertion( condition, __FILE__, __LINE__, format, __VA_ARGS__ )
 #	endif
 #ifdef _DEBUG
-#	define DebugAsssertion( condition, format, ... )									\
-		mage::Assertion( condition, __FILE__, __LINE__, format, __VA_ARGS__ )
+#	define DebugAsssertion( condition, ... )									\
+		mage::Assertion( condition, __FILE__, __LINE__, __VA_ARGS__ )
 #else
-#	define DebugAsssertion( condition, format, ... )
+#	define DebugAsssertion( condition, ... )
 #endif
 #else
-#	ifdef ANDROID
+#	if defined( ANDROID ) || defined( __GNUC__ )
 #		define assertion( condition, ... ) assert( condition )
 #	else
 #		define assertion( condition, format, ... ) assert( condition )
@@ -81,7 +81,7 @@ private:
 };
 #endif
 
-#ifdef ANDROID
+#if defined( ANDROID ) || defined( __linux__ )
 class ClockUnix
 	: public ClockPDI
 {
@@ -143,7 +143,7 @@ Clock::Clock()
 #ifdef WIN32
 	mClockPDI = new ClockWin32();
 #endif
-#ifdef ANDROID
+#if defined( ANDROID ) || defined( __linux__ )
 	mClockPDI = new ClockUnix();
 #endif
 }
@@ -264,7 +264,7 @@ double Clock::QueryTime( TimeFormat timeFormat )
 #ifdef WIN32
 	return ClockWin32::QueryTime( timeFormat );
 #endif
-#ifdef ANDROID
+#if defined( ANDROID ) || defined( __linux__ )
 	return ClockUnix::QueryTime( timeFormat );
 #endif
 }
@@ -538,11 +538,13 @@ int WriteDataFile( const char* fname, const char* buffer, unsigned int len )
 	return bytesWrote;
 }
 //---------------------------------------
+#ifdef ANDROID
 Resource* CreateResourceHandle( const char* path )
 {
     assertion( gAssetManager != NULL, "Must call InitializeAssetManager() before using FileSystem functions\n", "" );
     return new Resource( gAssetManager, path );
 }
+#endif
 //---------------------------------------
 
 #ifdef __cplusplus
@@ -60,8 +60,10 @@ namespace mage
 	int OpenDataFile( const char* fname, char*& _out_file, unsigned int& _out_len );
 	int WriteDataFile( const char* fname, const char* buffer, unsigned int len );
     
+#ifdef ANDROID
     // Create a Resource object to control reading of a file. You take full ownership of the handle.
     Resource* CreateResourceHandle( const char* path );
+#endif
 
 
 	// Generates some random ass files.
@@ -21,6 +21,8 @@ namespace mage
 	    off_t mLength;
 	};
 
+#ifdef ANDROID
+	// Resources are read through the Android asset manager, so they are only available on Android.
 	class Resource
 	{
 	public:
@@ -46,5 +48,6 @@ namespace mage
         AAssetManager* mAssetManager;
         AAsset* mAsset;
 	};
+#endif
 
 }
@@ -6,7 +6,7 @@
 // STD C++ Headers
 #include "stl_headers.h"
 
-#ifdef ANDROID
+#if defined( ANDROID ) || defined( __linux__ )
 #   define sprintf_s( buffer, format, ... ) sprintf( buffer, format, __VA_ARGS__ )
 #   define vsprintf_s( buffer, format, ... ) vsprintf( buffer, format, __VA_ARGS__ )
 #   define _snprintf_s(a,b,c,...) snprintf(a,b,__VA_ARGS__)
@@ -15,10 +15,13 @@
 #   define strcpy_s(a,b) strcpy(a,b)
 #   define strncpy_s(d,s,n) strncpy(d,s,n)
 #   define fopen_s(pfp,fn,m) *pfp=fopen(fn,m)
-#   define nullptr NULL
 #   define _stricmp(a,b) strcasecmp(a,b)
 #endif
 
+#ifdef ANDROID
+#   define nullptr NULL
+#endif
+
 #ifdef USE_MEMORY_MANAGER
 #	define new new( __FILE__, __LINE__ )
 #endif
@@ -38,7 +41,7 @@
 #include "Console.h"
 
 // Utility
-#include "Base64.h"
+#include "base64.h"
 #include "BitHacks.h"
 #include "HashUtil.h"
 #include "StringUtil.h"
@@ -214,7 +214,7 @@ bool StringUtil::ParseColor( const std::string& string, const Color& defaultValu
 		char* res;
 		uint32_t hex = (uint32_t) std::strtoul( &string[0]+1, &res, 16 );
 
-		if ( *res == nullptr )
+		if ( *res == '\0' )
 		{
 			result = Color( hex );
 		}
@@ -240,13 +240,11 @@ bool StringUtil::ParseColor( const std::string& string, const Color& defaultValu
 //---------------------------------------
 bool StringUtil::ParseIntRange( const std::string& string, const IntRange& defaultValue, IntRange& result )
 {
-	// TODO
-	return false;
+	return ParseRange< IntRange >( string, defaultValue, result, "IntRange" );
 }
 //---------------------------------------
 bool StringUtil::ParseFloatRange( const std::string& string, const FloatRange& defaultValue, FloatRange& result )
 {
-	// TODO
-	return false;
+	return ParseRange< FloatRange >( string, defaultValue, result, "FloatRange" );
 }
 //---------------------------------------
@@ -78,6 +78,10 @@ namespace mage
 		// Util to convert a n-dim vector encoded as "x,y,...n" to vectorN
 		template< typename TVector >
 		static bool ParseVector( const std::string& string, unsigned size, const TVector& defaultValue, TVector& result, const char* typeName );
+
+		// Util to convert a range encoded as "min~max" (or a single "value") to a Range
+		template< typename TRange >
+		static bool ParseRange( const std::string& string, const TRange& defaultValue, TRange& result, const char* typeName );
 	};
 
 	inline const char* BoolToCString( bool b ) { return b ? "True" : "False"; }
@@ -281,4 +285,43 @@ namespace mage
 
 		return success;
 	}
+
+
+	template< typename TRange >
+	bool StringUtil::ParseRange( const std::string& string, const TRange& defaultValue, TRange& result, const char* typeName )
+	{
+		bool success = true;
+
+		std::vector< std::string > tokens;
+		Tokenize( string, tokens, "~" );
+
+		if ( tokens.empty() || tokens.size() > 2 )
+		{
+			success = false;
+			WarnFail( "StringUtil : Could not parse %s: %s", typeName, tokens.empty() ? "Too few elements." : "Too many elements." );
+		}
+		else if ( !StringToType( tokens[0], &result.Min ) )
+		{
+			success = false;
+			WarnFail( "StringUtil : Could not parse %s: Min (\"%s\") is not a valid number.", typeName, tokens[0].c_str() );
+		}
+		else if ( tokens.size() == 1 )
+		{
+			// A single value means Min == Max.
+			result.Max = result.Min;
+		}
+		else if ( !StringToType( tokens[1], &result.Max ) )
+		{
+			success = false;
+			WarnFail( "StringUtil : Could not parse %s: Max (\"%s\") is not a valid number.", typeName, tokens[1].c_str() );
+		}
+
+		if( !success )
+		{
+			// If the value failed to parse, use the default value.
+			result = defaultValue;
+		}
+
+		return success;
+	}
 }
@@ -1215,7 +1215,7 @@ void XmlReader::XmlAssertError( const XmlReaderIterator& itr, int error, const c
 			const char* name = xmlAttrib->Name();
 			const char* value = xmlAttrib->Value();
 
-#ifdef ANDROID
+#if defined( ANDROID ) || defined( __linux__ )
             sprintf( attribBuffer + offset, "%s = %s\n", name, value );
 #else
 			sprintf_s( attribBuffer + offset, 1024 - offset, "%s = %s\n", name, value );
@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <cfloat>
+#include <climits>
 #include <cmath>
 
 namespace mage
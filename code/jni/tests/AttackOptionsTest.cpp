@@ -0,0 +1,140 @@
+#include "TestUtil.h"
+
+#include <algorithm>
+#include <tuple>
+
+using namespace mage;
+
+namespace
+{
+	typedef std::tuple< const Unit*, const Unit*, short, short, int, int > AttackKey;
+
+
+	AttackKey MakeAttackKey( const Unit* attacker, const Unit* target, const Vec2s& tilePos, int weaponIndex, int damagePercentage )
+	{
+		return std::make_tuple( attacker, target, tilePos.x, tilePos.y, weaponIndex, damagePercentage );
+	}
+
+
+	/**
+	 * Finds the attacks a Faction could make by asking each of its Units whether it can hit each enemy from each tile it can reach.
+	 */
+	void FindExpectedAttacks( Map& map, Faction* faction, std::vector< AttackKey >& result )
+	{
+		const Map::Units& units = map.GetUnits();
+
+		for( auto attackerIt = units.begin(); attackerIt != units.end(); ++attackerIt )
+		{
+			const Unit* attacker = *attackerIt;
+
+			if( !attacker->IsAlive() || attacker->GetOwner() != faction )
+			{
+				continue;
+			}
+
+			TileIndexSet reachableTiles = map.FindReachableTiles( attacker );
+
+			for( short y = 0; y < map.GetHeight(); ++y )
+			{
+				for( short x = 0; x < map.GetWidth(); ++x )
+				{
+					Vec2s tilePos( x, y );
+
+					if( !reachableTiles.Contains( map.GetCompactTileIndex( tilePos ) ) )
+					{
+						continue;
+					}
+
+					for( auto targetIt = units.begin(); targetIt != units.end(); ++targetIt )
+					{
+						const Unit* target = *targetIt;
+
+						if( target->IsAlive() && target->GetOwner() != faction && attacker->CanTarget( *target ) &&
+							attacker->IsInRangeFromTile( *target, map.GetTile( tilePos ) ) )
+						{
+							int weaponIndex = attacker->GetBestAvailableWeaponAgainst( *target );
+							result.push_back( MakeAttackKey( attacker, target, tilePos, weaponIndex, attacker->CalculateDamagePercentage( *target, weaponIndex ) ) );
+						}
+					}
+				}
+			}
+		}
+
+		std::sort( result.begin(), result.end() );
+	}
+
+
+	void CheckAttackOptions( Map& map, Faction* faction )
+	{
+		std::vector< AttackKey > expectedAttacks;
+		FindExpectedAttacks( map, faction, expectedAttacks );
+		CHECK( !expectedAttacks.empty() );
+
+		Map::AttackOptions options;
+		SearchContext context;
+		map.FindAttackOptions( faction, options, context );
+
+		std::vector< AttackKey > attacks;
+
+		for( auto it = options.begin(); it != options.end(); ++it )
+		{
+			attacks.push_back( MakeAttackKey( it->attacker, it->target, it->tilePos, it->weaponIndex, it->damagePercentage ) );
+		}
+
+		std::sort( attacks.begin(), attacks.end() );
+		CHECK( attacks == expectedAttacks );
+
+		// The search context of the main thread gives the same results.
+		Map::AttackOptions mainThreadOptions;
+		map.FindAttackOptions( faction, mainThreadOptions );
+		CHECK( mainThreadOptions.size() == options.size() );
+	}
+}
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	Map map;
+	map.Init( &scenario );
+	map.Resize( 10, 10 );
+	map.FillWithDefaultTerrainType();
+
+	// A City gives its occupant cover, and a strip of sea forces some Units to go around.
+	TestUtil::SetTerrain( map, 4, 3, scenario.TerrainTypes.FindByName( "City" ) );
+
+	for( short y = 0; y < 7; ++y )
+	{
+		TestUtil::SetTerrain( map, 6, y, scenario.TerrainTypes.FindByName( "Sea" ) );
+	}
+
+	map.FlushChangedTiles();
+
+	UnitType* tankType = scenario.UnitTypes.FindByName( "MediumTank" );
+	UnitType* infantryType = scenario.UnitTypes.FindByName( "Infantry" );
+	Faction* faction = map.CreateFaction();
+	Faction* enemyFaction = map.CreateFaction();
+
+	map.CreateUnit( tankType, faction, 2, 2 );
+	map.CreateUnit( infantryType, faction, 1, 5 );
+	map.CreateUnit( infantryType, faction, 5, 5, 4 );
+
+	map.CreateUnit( infantryType, enemyFaction, 4, 3 );
+	map.CreateUnit( tankType, enemyFaction, 4, 7, 7 );
+	map.CreateUnit( infantryType, enemyFaction, 9, 0 );
+
+	// Dead Units are never attacked.
+	Unit* deadUnit = map.CreateUnit( infantryType, enemyFaction, 3, 5 );
+	deadUnit->Die();
+
+	CheckAttackOptions( map, faction );
+	CheckAttackOptions( map, enemyFaction );
+
+	return TestUtil::GetExitCode();
+}
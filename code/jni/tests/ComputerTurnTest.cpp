@@ -0,0 +1,75 @@
+#include "TestUtil.h"
+
+using namespace mage;
+
+namespace
+{
+	const int MAX_TURN_COUNT = 40;
+}
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	Map map;
+	map.Init( &scenario );
+	map.Resize( 16, 12 );
+	map.FillWithDefaultTerrainType();
+
+	Faction* firstFaction = map.CreateFaction();
+	Faction* secondFaction = map.CreateFaction();
+	UnitType* tankType = scenario.UnitTypes.FindByName( "MediumTank" );
+	UnitType* infantryType = scenario.UnitTypes.FindByName( "Infantry" );
+	map.CreateUnit( tankType, firstFaction, 2, 5 );
+	map.CreateUnit( infantryType, firstFaction, 2, 7 );
+	map.CreateUnit( tankType, secondFaction, 13, 5 );
+	map.CreateUnit( infantryType, secondFaction, 13, 7 );
+
+	// Let the computer play both sides.
+	Game game;
+	game.Init( &map );
+	game.SetRandomSeed( 7 );
+
+	for( size_t i = 0; i < map.GetFactionCount(); ++i )
+	{
+		Player* player = game.CreatePlayer( map.GetFactionByIndex( i ) );
+		player->SetComputerControlled( true );
+	}
+
+	game.Start();
+	CHECK( game.IsInProgress() );
+	CHECK( game.GetCurrentPlayer() == game.GetPlayerByIndex( 0 ) );
+
+	int turnCount = 0;
+
+	while( game.IsInProgress() && turnCount < MAX_TURN_COUNT )
+	{
+		// Each computer turn ends by passing the turn to the next Player.
+		int turnNumber = game.GetTurnNumber();
+		game.PlayComputerTurn();
+		CHECK( game.IsGameOver() || game.GetTurnNumber() == turnNumber + 1 );
+		++turnCount;
+	}
+
+	std::printf( "Played %d computer turns (%s)\n", turnCount, ( game.IsGameOver() ? "game over" : "still in progress" ) );
+	CHECK( turnCount > 0 );
+
+	// Every Unit should still be on the Map, and no two living Units should share a tile.
+	for( auto it = map.GetUnits().begin(); it != map.GetUnits().end(); ++it )
+	{
+		CHECK( map.IsValidTilePos( ( *it )->GetTilePos() ) );
+
+		for( auto otherIt = it + 1; otherIt != map.GetUnits().end(); ++otherIt )
+		{
+			CHECK( !( *it )->IsAlive() || !( *otherIt )->IsAlive() || ( *it )->GetTilePos() != ( *otherIt )->GetTilePos() );
+		}
+	}
+
+	return TestUtil::GetExitCode();
+}
@@ -0,0 +1,129 @@
+#include "TestUtil.h"
+
+using namespace mage;
+
+namespace
+{
+	/**
+	 * Checks that the incrementally updated connectivity of a Map groups tiles the same way as a full rebuild.
+	 */
+	void CheckMatchesRebuild( Map& map, Scenario& scenario )
+	{
+		Map rebuiltMap;
+		rebuiltMap.Init( &scenario );
+		rebuiltMap.Resize( map.GetWidth(), map.GetHeight() );
+
+		for( short y = 0; y < map.GetHeight(); ++y )
+		{
+			for( short x = 0; x < map.GetWidth(); ++x )
+			{
+				TestUtil::SetTerrain( rebuiltMap, x, y, map.GetTile( x, y )->GetTerrainType() );
+			}
+		}
+
+		rebuiltMap.FlushChangedTiles();
+		rebuiltMap.UpdateConnectivity();
+		CHECK( map.IsConnectivityUpToDate() );
+
+		size_t tileCount = (size_t) ( map.GetWidth() * map.GetHeight() );
+		int mismatchCount = 0;
+
+		for( int movementTypeID = 0; movementTypeID < scenario.MovementTypes.GetRecordCount(); ++movementTypeID )
+		{
+			const MovementType* movementType = scenario.MovementTypes.FindByID( movementTypeID );
+
+			for( size_t first = 0; first < tileCount; ++first )
+			{
+				Vec2s firstPos( (short) ( first % map.GetWidth() ), (short) ( first / map.GetWidth() ) );
+
+				for( size_t second = first + 1; second < tileCount; ++second )
+				{
+					Vec2s secondPos( (short) ( second % map.GetWidth() ), (short) ( second / map.GetWidth() ) );
+
+					if( map.AreTilesConnected( movementType, firstPos, secondPos ) != rebuiltMap.AreTilesConnected( movementType, firstPos, secondPos ) )
+					{
+						++mismatchCount;
+					}
+				}
+			}
+		}
+
+		CHECK( mismatchCount == 0 );
+	}
+}
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	TerrainType* plainType = scenario.TerrainTypes.FindByName( "Plain" );
+	TerrainType* seaType = scenario.TerrainTypes.FindByName( "Sea" );
+	const MovementType* boots = scenario.MovementTypes.FindByName( "Boots" );
+
+	// A corridor along y=3, which is two tiles wide from x=6 to x=8, surrounded by sea.
+	Map map;
+	map.Init( &scenario );
+	map.Resize( 10, 7 );
+
+	for( short y = 0; y < map.GetHeight(); ++y )
+	{
+		for( short x = 0; x < map.GetWidth(); ++x )
+		{
+			bool isCorridor = ( y == 3 || ( y == 4 && x >= 6 && x <= 8 ) );
+			TestUtil::SetTerrain( map, x, y, ( isCorridor ? plainType : seaType ) );
+		}
+	}
+
+	map.FlushChangedTiles();
+	map.UpdateConnectivity();
+
+	Vec2s west( 0, 3 );
+	Vec2s east( 9, 3 );
+	CHECK( map.AreTilesConnected( boots, west, east ) );
+	CHECK( !map.AreTilesConnected( boots, west, Vec2s( 0, 0 ) ) );
+	CheckMatchesRebuild( map, scenario );
+
+	// A wall across the narrow part of the corridor splits it in two.
+	TestUtil::SetTerrain( map, 3, 3, seaType );
+	map.FlushChangedTiles();
+	CHECK( !map.AreTilesConnected( boots, west, east ) );
+	CHECK( map.AreTilesConnected( boots, west, Vec2s( 2, 3 ) ) );
+	CHECK( map.AreTilesConnected( boots, east, Vec2s( 4, 3 ) ) );
+	CheckMatchesRebuild( map, scenario );
+
+	// Removing the wall joins the two parts again.
+	TestUtil::SetTerrain( map, 3, 3, plainType );
+	map.FlushChangedTiles();
+	CHECK( map.AreTilesConnected( boots, west, east ) );
+	CheckMatchesRebuild( map, scenario );
+
+	// A wall in the wide part of the corridor can be walked around.
+	TestUtil::SetTerrain( map, 7, 3, seaType );
+	map.FlushChangedTiles();
+	CHECK( map.AreTilesConnected( boots, west, east ) );
+	CheckMatchesRebuild( map, scenario );
+
+	// Closing the way around as well splits the corridor.
+	TestUtil::SetTerrain( map, 7, 4, seaType );
+	map.FlushChangedTiles();
+	CHECK( !map.AreTilesConnected( boots, west, east ) );
+	CheckMatchesRebuild( map, scenario );
+
+	// Opening a new path through the sea joins the parts again (and connects a tile that used to be a wall).
+	TestUtil::SetTerrain( map, 6, 2, plainType );
+	TestUtil::SetTerrain( map, 7, 2, plainType );
+	TestUtil::SetTerrain( map, 8, 2, plainType );
+	map.FlushChangedTiles();
+	CHECK( map.AreTilesConnected( boots, west, east ) );
+	CHECK( map.AreTilesConnected( boots, west, Vec2s( 7, 2 ) ) );
+	CHECK( !map.AreTilesConnected( boots, west, Vec2s( 7, 3 ) ) );
+	CheckMatchesRebuild( map, scenario );
+
+	return TestUtil::GetExitCode();
+}
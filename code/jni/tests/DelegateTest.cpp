@@ -0,0 +1,182 @@
+#include "TestUtil.h"
+#include <cstdlib>
+
+using namespace mage;
+
+namespace
+{
+	int sAllocationCount = 0;
+
+
+	/**
+	 * Object with a method that can be wrapped by a Delegate.
+	 */
+	struct Counter
+	{
+		Counter() : total( 0 ) { }
+
+		int Add( int value )
+		{
+			total += value;
+			return total;
+		}
+
+		int total;
+	};
+
+
+	/**
+	 * Callable too large to fit in the inline storage of a Delegate.
+	 */
+	struct LargeFunction
+	{
+		int operator()( int value ) const
+		{
+			return ( value + padding[ 0 ] + padding[ 7 ] );
+		}
+
+		int64 padding[ 8 ];
+	};
+
+
+	int Double( int value )
+	{
+		return ( value * 2 );
+	}
+}
+
+
+// Count every allocation made by the program (the tests only compare counts before and after each operation).
+void* operator new( size_t size )
+{
+	++sAllocationCount;
+	void* result = std::malloc( size ? size : 1 );
+
+	if( !result )
+	{
+		throw std::bad_alloc();
+	}
+
+	return result;
+}
+
+
+void operator delete( void* pointer ) noexcept
+{
+	std::free( pointer );
+}
+
+
+int main()
+{
+	typedef Delegate< int, int > IntDelegate;
+	typedef FunctionRef< int, int > IntFunctionRef;
+
+	int offset = 3;
+	Counter counter;
+	int allocationCount = sAllocationCount;
+
+	// Small lambdas and object methods are stored inline.
+	IntDelegate lambdaDelegate( [&offset]( int value ) { return ( value + offset ); } );
+	IntDelegate methodDelegate( &counter, &Counter::Add );
+	CHECK( sAllocationCount == allocationCount );
+	CHECK( lambdaDelegate.Invoke( 1 ) == 4 );
+	CHECK( methodDelegate.Invoke( 2 ) == 2 );
+
+	// Copying and moving inline Delegates doesn't allocate either.
+	IntDelegate copiedDelegate( lambdaDelegate );
+	IntDelegate assignedDelegate;
+	assignedDelegate = methodDelegate;
+	IntDelegate movedDelegate( std::move( copiedDelegate ) );
+	IntDelegate moveAssignedDelegate;
+	moveAssignedDelegate = std::move( assignedDelegate );
+	CHECK( sAllocationCount == allocationCount );
+	CHECK( !copiedDelegate.IsValid() );
+	CHECK( !assignedDelegate.IsValid() );
+	CHECK( movedDelegate.Invoke( 2 ) == 5 );
+	CHECK( moveAssignedDelegate.Invoke( 3 ) == 5 );
+
+	// Large callables are allocated once, copies allocate their own wrapper and moves steal it.
+	LargeFunction largeFunction = { { 10, 0, 0, 0, 0, 0, 0, 20 } };
+	IntDelegate largeDelegate( largeFunction );
+	CHECK( sAllocationCount == allocationCount + 1 );
+
+	IntDelegate copiedLargeDelegate( largeDelegate );
+	CHECK( sAllocationCount == allocationCount + 2 );
+
+	IntDelegate movedLargeDelegate( std::move( largeDelegate ) );
+	IntDelegate moveAssignedLargeDelegate;
+	moveAssignedLargeDelegate = std::move( copiedLargeDelegate );
+	CHECK( sAllocationCount == allocationCount + 2 );
+	CHECK( !largeDelegate.IsValid() );
+	CHECK( movedLargeDelegate.Invoke( 1 ) == 31 );
+	CHECK( moveAssignedLargeDelegate.Invoke( 2 ) == 32 );
+
+	// FunctionRefs never allocate, whether they reference a lambda, a large callable or a Delegate.
+	allocationCount = sAllocationCount;
+	auto lambda = [&offset]( int value ) { return ( value * offset ); };
+	IntFunctionRef lambdaRef( lambda );
+	IntFunctionRef largeRef( largeFunction );
+	IntFunctionRef delegateRef( movedLargeDelegate );
+	IntFunctionRef copiedRef( lambdaRef );
+	IntFunctionRef functionRef( Double );
+	int (*functionPointer)( int ) = &Double;
+	IntFunctionRef functionPointerRef( functionPointer );
+	functionPointer = nullptr;
+	CHECK( sAllocationCount == allocationCount );
+	CHECK( lambdaRef.Invoke( 2 ) == 6 );
+	CHECK( largeRef.Invoke( 0 ) == 30 );
+	CHECK( delegateRef.Invoke( 0 ) == 30 );
+	CHECK( copiedRef.Invoke( 3 ) == 9 );
+	CHECK( functionRef.Invoke( 4 ) == 8 );
+	CHECK( functionPointerRef.Invoke( 5 ) == 10 );
+	CHECK( !IntFunctionRef( (int (*)( int )) nullptr ).IsValid() );
+
+	// Visiting the Units of a Map with a capturing lambda doesn't allocate.
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	Map map;
+	map.Init( &scenario );
+	map.Resize( 8, 8 );
+	map.FillWithDefaultTerrainType();
+
+	Faction* faction = map.CreateFaction();
+	map.CreateUnit( scenario.UnitTypes.FindByName( "Infantry" ), faction, 1, 1 );
+	map.CreateUnit( scenario.UnitTypes.FindByName( "Infantry" ), faction, 2, 2 );
+
+	int unitCount = 0;
+	allocationCount = sAllocationCount;
+
+	map.ForEachUnit( [&unitCount, faction]( Unit* unit )
+	{
+		unitCount += ( unit->GetOwner() == faction ? 1 : 0 );
+	});
+
+	CHECK( sAllocationCount == allocationCount );
+	CHECK( unitCount == 2 );
+
+	// Delegates can be passed to the templated Grid visitors.
+	int tileCount = 0;
+	Delegate< void, const Map::Iterator& > countTileDelegate( [&tileCount]( const Map::Iterator& tile )
+	{
+		tileCount += ( tile.IsValid() ? 1 : 0 );
+	});
+
+	map.ForEachTile( countTileDelegate );
+	CHECK( tileCount == 8 * 8 );
+
+	tileCount = 0;
+	map.ForEachTileInArea( RectS( 0, 0, 2, 3 ), countTileDelegate );
+	CHECK( tileCount == 2 * 3 );
+
+	tileCount = 0;
+	map.GetTile( 0, 0 ).ForEachAdjacent( countTileDelegate );
+	CHECK( tileCount == 3 );
+
+	return TestUtil::GetExitCode();
+}
@@ -0,0 +1,64 @@
+#include "TestUtil.h"
+
+using namespace mage;
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	Map map;
+	map.Init( &scenario );
+	map.Resize( 8, 8 );
+	map.FillWithDefaultTerrainType();
+
+	// The first Faction has a Unit, the second only has a headquarters.
+	TerrainType* cityType = scenario.TerrainTypes.FindByName( "City" );
+	TestUtil::SetTerrain( map, 6, 6, cityType );
+	map.FlushChangedTiles();
+
+	Faction* firstFaction = map.CreateFaction();
+	Faction* secondFaction = map.CreateFaction();
+	map.CreateUnit( scenario.UnitTypes.FindByName( "Infantry" ), firstFaction, 1, 1 );
+
+	Map::Iterator headquarters = map.GetTile( 6, 6 );
+	headquarters->SetOwner( secondFaction );
+	secondFaction->SetHeadquarters( headquarters );
+
+	Game game;
+	game.Init( &map );
+	game.CreatePlayer( firstFaction );
+	game.CreatePlayer( secondFaction );
+	game.Start();
+
+	GameSnapshot snapshot;
+	snapshot.Capture( &game );
+
+	// A Faction that never had Units isn't defeated while it holds its headquarters (the same as Faction::IsDefeated).
+	CHECK( !secondFaction->IsDefeated() );
+	CHECK( snapshot.GetFaction( 1 ).headquartersTileIndex == (int) map.GetCompactTileIndex( Vec2s( 6, 6 ) ) );
+	CHECK( !snapshot.IsDefeated( 0 ) );
+	CHECK( !snapshot.IsDefeated( 1 ) );
+	CHECK( snapshot.GetWinningFactionIndex() == GameSnapshot::NO_FACTION );
+
+	// Losing the headquarters tile defeats the Faction.
+	GameSnapshot capturedSnapshot = snapshot;
+	capturedSnapshot.SetTileOwner( capturedSnapshot.GetTileIndex( 6, 6 ), 0 );
+	CHECK( capturedSnapshot.GetFaction( 1 ).hasLostHeadquarters );
+	CHECK( capturedSnapshot.IsDefeated( 1 ) );
+	CHECK( capturedSnapshot.GetWinningFactionIndex() == 0 );
+
+	// The snapshot picks up a headquarters that was already lost in the Game.
+	headquarters->SetOwner( firstFaction );
+	CHECK( secondFaction->IsDefeated() );
+	snapshot.Capture( &game );
+	CHECK( snapshot.GetFaction( 1 ).hasLostHeadquarters );
+	CHECK( snapshot.GetWinningFactionIndex() == 0 );
+
+	return TestUtil::GetExitCode();
+}
@@ -0,0 +1,84 @@
+#include "TestUtil.h"
+
+using namespace mage;
+
+namespace
+{
+	/**
+	 * Checks that the running income of each Faction matches the income of the tiles it owns.
+	 */
+	void CheckIncome( Map& map, int firstIncome, int secondIncome )
+	{
+		const Map::Factions& factions = map.GetFactions();
+		CHECK( factions[ 0 ]->GetIncome() == firstIncome );
+		CHECK( factions[ 1 ]->GetIncome() == secondIncome );
+
+		for( auto it = factions.begin(); it != factions.end(); ++it )
+		{
+			CHECK( ( *it )->GetIncome() == ( *it )->CalculateIncome() );
+		}
+	}
+}
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	Map map;
+	map.Init( &scenario );
+	map.Resize( 8, 8 );
+	map.FillWithDefaultTerrainType();
+
+	TerrainType* cityType = scenario.TerrainTypes.FindByName( "City" );
+	TerrainType* plainType = scenario.TerrainTypes.FindByName( "Plain" );
+	int cityIncome = cityType->GetIncome();
+	CHECK( cityIncome > 0 );
+
+	TestUtil::SetTerrain( map, 1, 1, cityType );
+	TestUtil::SetTerrain( map, 2, 1, cityType );
+	TestUtil::SetTerrain( map, 6, 6, cityType );
+	map.FlushChangedTiles();
+
+	Faction* firstFaction = map.CreateFaction();
+	Faction* secondFaction = map.CreateFaction();
+	CheckIncome( map, 0, 0 );
+
+	// Gain tiles.
+	map.GetTile( 1, 1 )->SetOwner( firstFaction );
+	map.GetTile( 2, 1 )->SetOwner( firstFaction );
+	map.GetTile( 6, 6 )->SetOwner( secondFaction );
+	CheckIncome( map, 2 * cityIncome, cityIncome );
+
+	// Tiles that cannot be captured are never owned.
+	map.GetTile( 4, 4 )->SetOwner( firstFaction );
+	CHECK( !map.GetTile( 4, 4 )->HasOwner() );
+	CheckIncome( map, 2 * cityIncome, cityIncome );
+
+	// Capture a tile from the other Faction.
+	map.GetTile( 2, 1 )->SetOwner( secondFaction );
+	CheckIncome( map, cityIncome, 2 * cityIncome );
+
+	// Lose a tile.
+	map.GetTile( 6, 6 )->ClearOwner();
+	CheckIncome( map, cityIncome, cityIncome );
+
+	// Retype an owned tile (the tile can no longer be captured, so it also loses its owner).
+	TestUtil::SetTerrain( map, 1, 1, plainType );
+	map.FlushChangedTiles();
+	CHECK( !map.GetTile( 1, 1 )->HasOwner() );
+	CheckIncome( map, 0, cityIncome );
+
+	// Retype it back and capture it again.
+	TestUtil::SetTerrain( map, 1, 1, cityType );
+	map.FlushChangedTiles();
+	map.GetTile( 1, 1 )->SetOwner( firstFaction );
+	CheckIncome( map, cityIncome, cityIncome );
+
+	return TestUtil::GetExitCode();
+}
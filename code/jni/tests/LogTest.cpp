@@ -0,0 +1,109 @@
+#include "TestUtil.h"
+
+#include <cstring>
+#include <string>
+
+using namespace mage;
+
+namespace
+{
+	const int WRITER_COUNT = 4;
+	const int MESSAGES_PER_WRITER = 1000;
+
+
+	int CountEvaluation( int& evaluationCount )
+	{
+		return ++evaluationCount;
+	}
+}
+
+
+int main()
+{
+	// Keep the console quiet (the ring buffer keeps every enabled message regardless of the console level).
+	Log::SetConsoleLevel( LOG_LEVEL_NONE );
+
+	// Messages below the runtime level are skipped without evaluating their arguments.
+	int evaluationCount = 0;
+	Log::SetLevel( LOG_LEVEL_WARNING );
+	CHECK( !Log::IsLevelEnabled( LOG_LEVEL_INFO ) );
+	CHECK( Log::IsLevelEnabled( LOG_LEVEL_WARNING ) );
+	CHECK( Log::IsLevelEnabled( LOG_LEVEL_ERROR ) );
+
+	LogTrace( "Trace %d", CountEvaluation( evaluationCount ) );
+	LogInfo( "Info %d", CountEvaluation( evaluationCount ) );
+	CHECK( evaluationCount == 0 );
+
+	LogWarning( "Warning %d", CountEvaluation( evaluationCount ) );
+	LogError( "Error %d", CountEvaluation( evaluationCount ) );
+	CHECK( evaluationCount == 2 );
+
+	Log::Messages messages;
+	Log::GetRecentMessages( messages );
+	CHECK( messages.size() == 2 );
+
+	if( messages.size() == 2 )
+	{
+		CHECK( messages[ 0 ].level == LOG_LEVEL_WARNING && std::strcmp( messages[ 0 ].text, "Warning 1" ) == 0 );
+		CHECK( messages[ 1 ].level == LOG_LEVEL_ERROR && std::strcmp( messages[ 1 ].text, "Error 2" ) == 0 );
+		CHECK( messages[ 0 ].sequence + 1 == messages[ 1 ].sequence );
+	}
+
+	CHECK( std::strcmp( Log::GetLevelName( LOG_LEVEL_WARNING ), "Warning" ) == 0 );
+	CHECK( std::strcmp( Log::GetLevelName( LOG_LEVEL_NONE ), "None" ) == 0 );
+
+	// Long messages are truncated to fit in their slot.
+	Log::SetLevel( LOG_LEVEL_TRACE );
+	std::string longText( Log::MAX_MESSAGE_LENGTH * 2, 'x' );
+	LogDebug( "%s", longText.c_str() );
+	Log::GetRecentMessages( messages );
+	CHECK( !messages.empty() && std::strlen( messages.back().text ) == Log::MAX_MESSAGE_LENGTH - 1 );
+
+	// Once the ring buffer wraps around, only the most recent messages are kept (oldest first).
+	for( size_t i = 0; i < Log::MESSAGE_COUNT + 10; ++i )
+	{
+		LogInfo( "Message %d", (int) i );
+	}
+
+	Log::GetRecentMessages( messages );
+	CHECK( messages.size() == Log::MESSAGE_COUNT );
+
+	if( messages.size() == Log::MESSAGE_COUNT )
+	{
+		CHECK( std::strcmp( messages.front().text, "Message 10" ) == 0 );
+		CHECK( std::strcmp( messages.back().text, "Message 265" ) == 0 );
+	}
+
+	// Writers on several threads never leave a torn message behind.
+	WorkerGroup::Run( WRITER_COUNT, []( int workerIndex )
+	{
+		for( int i = 0; i < MESSAGES_PER_WRITER; ++i )
+		{
+			LogInfo( "Worker %d message %d", workerIndex, i );
+		}
+	});
+
+	Log::GetRecentMessages( messages );
+	CHECK( messages.size() == Log::MESSAGE_COUNT );
+	int malformedCount = 0;
+
+	for( auto it = messages.begin(); it != messages.end(); ++it )
+	{
+		int workerIndex = -1;
+		int messageIndex = -1;
+		char expectedText[ Log::MAX_MESSAGE_LENGTH ];
+
+		if( std::sscanf( it->text, "Worker %d message %d", &workerIndex, &messageIndex ) != 2 )
+		{
+			++malformedCount;
+			continue;
+		}
+
+		std::snprintf( expectedText, sizeof( expectedText ), "Worker %d message %d", workerIndex, messageIndex );
+		malformedCount += ( std::strcmp( expectedText, it->text ) != 0 || it->level != LOG_LEVEL_INFO ? 1 : 0 );
+	}
+
+	CHECK( malformedCount == 0 );
+
+	return TestUtil::GetExitCode();
+}
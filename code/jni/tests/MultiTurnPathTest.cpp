@@ -0,0 +1,289 @@
+#include "TestUtil.h"
+#include <map>
+
+using namespace mage;
+
+namespace
+{
+	const short MAP_WIDTH = 24;
+	const short MAP_HEIGHT = 16;
+	const int RANDOM_MAP_COUNT = 20;
+	const int QUERIES_PER_MAP = 20;
+
+
+	/**
+	 * The best (turn, movement spent during that turn) to reach a tile, found by searching every way the Unit could
+	 * spend its movement, including ending its turn early.
+	 */
+	struct BruteForceResult
+	{
+		bool isFound;
+		int turnIndex;
+		int costThisTurn;
+	};
+
+
+	BruteForceResult FindBestTurnsByBruteForce( const Map& map, const Unit* unit, const Vec2s& goalPos, int maxTurnCount )
+	{
+		const int* movementCosts = map.GetScenario()->GetMovementCostsByTerrainTypeID( unit->GetMovementType() );
+		int movementRange = unit->GetUnitType()->GetMovementRange();
+		int turnStride = ( movementRange + 1 );
+
+		// Look up who is standing on each tile.
+		std::map< size_t, const Unit* > tileUnits;
+
+		for( auto it = map.GetUnits().begin(); it != map.GetUnits().end(); ++it )
+		{
+			if( *it != unit && ( *it )->IsAlive() )
+			{
+				tileUnits[ map.GetCompactTileIndex( ( *it )->GetTilePos() ) ] = *it;
+			}
+		}
+
+		// Each state is (tile, turn, movement spent this turn), keyed by turn then movement spent.
+		size_t tileCount = ( (size_t) map.GetWidth() * (size_t) map.GetHeight() );
+		size_t stateCount = ( tileCount * (size_t) maxTurnCount * (size_t) turnStride );
+		std::vector< bool > isVisited( stateCount, false );
+		IndexedMinHeap< int > openList( stateCount );
+		size_t goalIndex = map.GetCompactTileIndex( goalPos );
+		size_t originIndex = map.GetCompactTileIndex( unit->GetTilePos() );
+		openList.insert( 0, originIndex );
+
+		while( !openList.isEmpty() )
+		{
+			IndexedMinHeap< int >::Pair pair = openList.popMinNode();
+			size_t tileIndex = ( pair.index % tileCount );
+			int turnIndex = ( pair.key / turnStride );
+			int costThisTurn = ( pair.key % turnStride );
+			isVisited[ pair.index ] = true;
+
+			if( tileIndex == goalIndex )
+			{
+				BruteForceResult result = { true, turnIndex, costThisTurn };
+				return result;
+			}
+
+			std::vector< std::pair< size_t, int > > nextStates;
+			auto tileUnit = tileUnits.find( tileIndex );
+
+			if( ( tileUnit == tileUnits.end() ) && turnIndex + 1 < maxTurnCount )
+			{
+				// Wait here until the next turn.
+				nextStates.push_back( std::make_pair( tileIndex, ( turnIndex + 1 ) * turnStride ) );
+			}
+
+			Vec2s tilePos = map.GetTilePosFromCompactIndex( tileIndex );
+
+			for( size_t i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
+			{
+				Vec2s adjacentPos = ( tilePos + CARDINAL_DIRECTIONS[ i ].GetOffset() );
+
+				if( !map.IsValidTilePos( adjacentPos ) )
+				{
+					continue;
+				}
+
+				size_t adjacentIndex = map.GetCompactTileIndex( adjacentPos );
+				int cost = movementCosts[ map.GetTerrainTypeID( adjacentIndex ) ];
+				auto adjacentUnit = tileUnits.find( adjacentIndex );
+				bool isBlocked = ( adjacentUnit != tileUnits.end() && adjacentUnit->second->GetOwner() != unit->GetOwner() );
+
+				if( cost > -1 && !isBlocked && costThisTurn + cost <= movementRange )
+				{
+					nextStates.push_back( std::make_pair( adjacentIndex, pair.key + cost ) );
+				}
+			}
+
+			for( auto it = nextStates.begin(); it != nextStates.end(); ++it )
+			{
+				size_t stateIndex = ( ( (size_t) it->second ) * tileCount + it->first );
+
+				if( isVisited[ stateIndex ] )
+				{
+					continue;
+				}
+
+				if( !openList.hasIndex( stateIndex ) )
+				{
+					openList.insert( it->second, stateIndex );
+				}
+				else if( it->second < openList.getKey( stateIndex ) )
+				{
+					openList.update( it->second, stateIndex );
+				}
+			}
+		}
+
+		BruteForceResult result = { false, 0, 0 };
+		return result;
+	}
+
+
+	void CheckPath( const Map& map, const Unit* unit, const Vec2s& goalPos, const Path& path, const BruteForceResult& expected )
+	{
+		const int* movementCosts = map.GetScenario()->GetMovementCostsByTerrainTypeID( unit->GetMovementType() );
+		int movementRange = unit->GetUnitType()->GetMovementRange();
+
+		// Walk the path one turn at a time, making sure each turn stays within the Unit's movement range and ends on a
+		// tile the Unit can stop on.
+		Vec2s tilePos = unit->GetTilePos();
+		size_t directionIndex = 0;
+		int costThisTurn = 0;
+
+		for( size_t turnIndex = 0; turnIndex < path.GetTurnCount(); ++turnIndex )
+		{
+			costThisTurn = 0;
+
+			for( ; directionIndex < path.GetTurnEndIndex( turnIndex ); ++directionIndex )
+			{
+				tilePos = ( tilePos + path.GetDirection( directionIndex ).GetOffset() );
+				CHECK( map.IsValidTilePos( tilePos ) );
+
+				Map::ConstIterator tile = map.GetTile( tilePos );
+				const Unit* tileUnit = tile->GetUnit();
+				CHECK( tileUnit == nullptr || tileUnit->GetOwner() == unit->GetOwner() );
+				costThisTurn += movementCosts[ tile->GetTerrainType()->GetID() ];
+			}
+
+			CHECK( costThisTurn <= movementRange );
+			CHECK( map.GetTile( tilePos )->GetUnit() == nullptr || tilePos == unit->GetTilePos() );
+		}
+
+		// The path should end on the goal, and take as few turns (and as little movement on the last turn) as possible.
+		CHECK( tilePos == goalPos );
+		CHECK( (int) path.GetTurnCount() == expected.turnIndex + 1 );
+		CHECK( costThisTurn == expected.costThisTurn );
+	}
+
+
+	void TestFriendlyUnitOnTurnEnd( Scenario& scenario )
+	{
+		// Build a corridor one tile wide.
+		TerrainType* sea = scenario.TerrainTypes.FindByName( "Sea" );
+		Map map;
+		map.Init( &scenario );
+		map.Resize( 20, 3 );
+		map.FillWithDefaultTerrainType();
+
+		for( short x = 0; x < 20; ++x )
+		{
+			TestUtil::SetTerrain( map, x, 0, sea );
+			TestUtil::SetTerrain( map, x, 2, sea );
+		}
+
+		map.FlushChangedTiles();
+
+		// Put a friendly Unit exactly where the Unit's first turn would end.
+		Faction* faction = map.CreateFaction();
+		UnitType* tankType = scenario.UnitTypes.FindByName( "Tank" );
+		Unit* unit = map.CreateUnit( tankType, faction, 0, 1 );
+		short movementRange = (short) tankType->GetMovementRange();
+		map.CreateUnit( scenario.UnitTypes.FindByName( "Infantry" ), faction, movementRange, 1 );
+
+		// The Unit has to stop one tile early, then pass the friendly Unit on its second turn.
+		Path path;
+		Vec2s goalPos( movementRange + 4, 1 );
+		bool isFound = map.FindMultiTurnPath( unit, goalPos, path );
+		CHECK( isFound );
+
+		if( isFound )
+		{
+			CHECK( path.GetTurnCount() == 2 );
+			CHECK( path.GetTurnEndIndex( 0 ) == (size_t) movementRange - 1 );
+			CHECK( path.GetDestination() == goalPos );
+		}
+
+		// An enemy Unit in the corridor blocks the way entirely.
+		map.CreateUnit( scenario.UnitTypes.FindByName( "Infantry" ), map.CreateFaction(), movementRange + 2, 1 );
+		CHECK( !map.FindMultiTurnPath( unit, goalPos, path ) );
+	}
+
+
+	void TestRandomMaps( Scenario& scenario )
+	{
+		TerrainType* sea = scenario.TerrainTypes.FindByName( "Sea" );
+		UnitType* tankType = scenario.UnitTypes.FindByName( "Tank" );
+		UnitType* infantryType = scenario.UnitTypes.FindByName( "Infantry" );
+		RandomStream random( 42 );
+		int foundCount = 0;
+
+		for( int mapIndex = 0; mapIndex < RANDOM_MAP_COUNT; ++mapIndex )
+		{
+			Map map;
+			map.Init( &scenario );
+			map.Resize( MAP_WIDTH, MAP_HEIGHT );
+			map.FillWithDefaultTerrainType();
+
+			for( int i = 0; i < MAP_WIDTH * MAP_HEIGHT / 5; ++i )
+			{
+				TestUtil::SetTerrain( map, (short) random.RandomInRange( 0, MAP_WIDTH - 1 ), (short) random.RandomInRange( 0, MAP_HEIGHT - 1 ), sea );
+			}
+
+			map.FlushChangedTiles();
+
+			// Scatter friendly and enemy Units over the land.
+			Faction* faction = map.CreateFaction();
+			Faction* enemyFaction = map.CreateFaction();
+			std::vector< Unit* > units;
+
+			for( int i = 0; i < 40; ++i )
+			{
+				Vec2s tilePos( (short) random.RandomInRange( 0, MAP_WIDTH - 1 ), (short) random.RandomInRange( 0, MAP_HEIGHT - 1 ) );
+				Map::ConstIterator tile = map.GetTile( tilePos );
+
+				if( tile->GetTerrainType() != sea && tile->GetUnit() == nullptr )
+				{
+					bool isFriendly = ( i % 3 != 0 );
+					units.push_back( map.CreateUnit( ( isFriendly ? tankType : infantryType ), ( isFriendly ? faction : enemyFaction ), tilePos ) );
+				}
+			}
+
+			for( int i = 0; i < QUERIES_PER_MAP; ++i )
+			{
+				Unit* unit = units[ random.RandomInRange( 0, (int) units.size() - 1 ) ];
+
+				if( unit->GetOwner() != faction )
+				{
+					continue;
+				}
+
+				Vec2s goalPos( (short) random.RandomInRange( 0, MAP_WIDTH - 1 ), (short) random.RandomInRange( 0, MAP_HEIGHT - 1 ) );
+
+				if( map.GetTile( goalPos )->GetUnit() != nullptr )
+				{
+					continue;
+				}
+
+				// Compare the path to the best one found by brute force.
+				Path path;
+				bool isFound = map.FindMultiTurnPath( unit, goalPos, path );
+				BruteForceResult expected = FindBestTurnsByBruteForce( map, unit, goalPos, Map::DEFAULT_MAX_TURN_COUNT );
+				CHECK( isFound == expected.isFound );
+
+				if( isFound && expected.isFound )
+				{
+					CheckPath( map, unit, goalPos, path, expected );
+					++foundCount;
+				}
+			}
+		}
+
+		std::printf( "%d random paths checked\n", foundCount );
+		CHECK( foundCount > 0 );
+	}
+}
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	TestFriendlyUnitOnTurnEnd( scenario );
+	TestRandomMaps( scenario );
+	return TestUtil::GetExitCode();
+}
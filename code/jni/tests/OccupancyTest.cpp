@@ -0,0 +1,79 @@
+#include "TestUtil.h"
+
+using namespace mage;
+
+namespace
+{
+	const short MAP_SIZE = 8;
+	const short CORRIDOR_Y = 4;
+
+
+	bool IsReachable( Map& map, const Unit* unit, short tileX, short tileY )
+	{
+		return map.FindReachableTiles( unit ).Contains( map.GetCompactTileIndex( Vec2s( tileX, tileY ) ) );
+	}
+}
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	Map map;
+	map.Init( &scenario );
+	map.Resize( MAP_SIZE, MAP_SIZE );
+	map.FillWithDefaultTerrainType();
+
+	// Wall in a one-tile-wide corridor so Units can't walk around each other.
+	TerrainType* seaType = scenario.TerrainTypes.FindByName( "Sea" );
+
+	for( short x = 0; x < MAP_SIZE; ++x )
+	{
+		TestUtil::SetTerrain( map, x, CORRIDOR_Y - 1, seaType );
+		TestUtil::SetTerrain( map, x, CORRIDOR_Y + 1, seaType );
+	}
+
+	map.FlushChangedTiles();
+
+	// Infantry can move 3 tiles along the corridor.
+	Faction* faction = map.CreateFaction();
+	Faction* enemyFaction = map.CreateFaction();
+	UnitType* infantryType = scenario.UnitTypes.FindByName( "Infantry" );
+	Unit* unit = map.CreateUnit( infantryType, faction, 1, CORRIDOR_Y );
+	CHECK( IsReachable( map, unit, 4, CORRIDOR_Y ) );
+
+	// Enemy Units block the search.
+	Unit* enemy = map.CreateUnit( infantryType, enemyFaction, 3, CORRIDOR_Y );
+	CHECK( IsReachable( map, unit, 2, CORRIDOR_Y ) );
+	CHECK( !IsReachable( map, unit, 3, CORRIDOR_Y ) );
+	CHECK( !IsReachable( map, unit, 4, CORRIDOR_Y ) );
+
+	// Friendly Units can be passed but not stopped on.
+	enemy->Die();
+	Unit* friendly = map.CreateUnit( infantryType, faction, 3, CORRIDOR_Y );
+	CHECK( !IsReachable( map, unit, 3, CORRIDOR_Y ) );
+	CHECK( IsReachable( map, unit, 4, CORRIDOR_Y ) );
+
+	Path path;
+	map.FindBestPathToTile( unit, Vec2s( 4, CORRIDOR_Y ), path );
+	CHECK( path.IsValid() && path.GetLength() == 3 );
+
+	// Once a Unit dies its tile is free, and another Unit can move onto it.
+	friendly->Die();
+	CHECK( map.GetTile( 3, CORRIDOR_Y )->IsEmpty() );
+	CHECK( IsReachable( map, unit, 3, CORRIDOR_Y ) );
+
+	map.FindBestPathToTile( unit, Vec2s( 3, CORRIDOR_Y ), path );
+	CHECK( path.IsValid() && path.GetLength() == 2 );
+	unit->Move( path );
+	CHECK( unit->GetTilePos() == Vec2s( 3, CORRIDOR_Y ) );
+	CHECK( map.GetTile( 3, CORRIDOR_Y )->GetUnit() == unit );
+	CHECK( map.GetTile( 1, CORRIDOR_Y )->IsEmpty() );
+
+	return TestUtil::GetExitCode();
+}
@@ -0,0 +1,177 @@
+#include "TestUtil.h"
+
+using namespace mage;
+
+namespace
+{
+	const short MAP_WIDTH = 64;
+	const short MAP_HEIGHT = 48;
+	const int QUERY_COUNT = 400;
+
+	// Paths through the cluster graph pass through the middle of each border crossing, so they may be a little
+	// longer than the best path. Allow a detour of up to one cluster side for each cluster the path crosses.
+	const int DETOUR_PER_CLUSTER = PathHierarchy::CLUSTER_SIZE;
+
+
+	void BuildMap( Map& map, Scenario& scenario )
+	{
+		TerrainType* sea = scenario.TerrainTypes.FindByName( "Sea" );
+		TerrainType* road = scenario.TerrainTypes.FindByName( "Road" );
+		TerrainType* city = scenario.TerrainTypes.FindByName( "City" );
+
+		map.Init( &scenario );
+		map.Resize( MAP_WIDTH, MAP_HEIGHT );
+		map.FillWithDefaultTerrainType();
+
+		// Walls of sea with a few gaps, so that some paths have to wind between clusters.
+		for( short y = 0; y < MAP_HEIGHT; ++y )
+		{
+			if( y % 11 != 5 && y % 17 != 9 )
+			{
+				TestUtil::SetTerrain( map, 20, y, sea );
+			}
+
+			if( y % 13 != 2 )
+			{
+				TestUtil::SetTerrain( map, 41, y, sea );
+			}
+		}
+
+		for( short x = 0; x < MAP_WIDTH; ++x )
+		{
+			if( x % 19 != 7 )
+			{
+				TestUtil::SetTerrain( map, x, 30, sea );
+			}
+
+			// A road, which is cheaper to drive on.
+			TestUtil::SetTerrain( map, x, 12, road );
+		}
+
+		// Scatter some lakes and cities.
+		RandomStream random( 1234 );
+
+		for( int i = 0; i < 200; ++i )
+		{
+			short x = (short) random.RandomInRange( 0, MAP_WIDTH - 1 );
+			short y = (short) random.RandomInRange( 0, MAP_HEIGHT - 1 );
+			TestUtil::SetTerrain( map, x, y, ( i % 3 == 0 ? city : sea ) );
+		}
+
+		map.FlushChangedTiles();
+	}
+
+
+	int GetPathCost( const Map& map, const int* movementCosts, const Vec2s& originPos, const Vec2s& goalPos, const Path& path )
+	{
+		// Walk the path, making sure every step can be taken, and add up the cost of entering each tile.
+		int totalCost = 0;
+		Vec2s tilePos = originPos;
+
+		for( size_t i = 0; i < path.GetLength(); ++i )
+		{
+			tilePos = ( tilePos + path.GetDirection( i ).GetOffset() );
+
+			if( !map.IsValidTilePos( tilePos ) )
+			{
+				return -1;
+			}
+
+			int cost = movementCosts[ map.GetTerrainTypeID( map.GetCompactTileIndex( tilePos ) ) ];
+
+			if( cost < 0 )
+			{
+				return -1;
+			}
+
+			totalCost += cost;
+		}
+
+		return ( tilePos == goalPos ? totalCost : -1 );
+	}
+
+
+	int GetClustersCrossed( const Path& path, const Vec2s& originPos )
+	{
+		int clusterCount = 1;
+		Vec2s tilePos = originPos;
+
+		for( size_t i = 0; i < path.GetLength(); ++i )
+		{
+			Vec2s nextPos = ( tilePos + path.GetDirection( i ).GetOffset() );
+
+			if( nextPos.x / PathHierarchy::CLUSTER_SIZE != tilePos.x / PathHierarchy::CLUSTER_SIZE ||
+				nextPos.y / PathHierarchy::CLUSTER_SIZE != tilePos.y / PathHierarchy::CLUSTER_SIZE )
+			{
+				++clusterCount;
+			}
+
+			tilePos = nextPos;
+		}
+
+		return clusterCount;
+	}
+}
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	Map map;
+	BuildMap( map, scenario );
+
+	SearchContext context;
+	RandomStream random( 5678 );
+	int foundCount = 0;
+	int optimalCount = 0;
+
+	for( int i = 0; i < QUERY_COUNT; ++i )
+	{
+		const MovementType* movementType = scenario.MovementTypes.FindByID( i % scenario.MovementTypes.GetRecordCount() );
+		const int* movementCosts = scenario.GetMovementCostsByTerrainTypeID( movementType );
+		Vec2s originPos( (short) random.RandomInRange( 0, MAP_WIDTH - 1 ), (short) random.RandomInRange( 0, MAP_HEIGHT - 1 ) );
+		Vec2s goalPos( (short) random.RandomInRange( 0, MAP_WIDTH - 1 ), (short) random.RandomInRange( 0, MAP_HEIGHT - 1 ) );
+
+		if( movementCosts[ map.GetTerrainTypeID( map.GetCompactTileIndex( originPos ) ) ] < 0 )
+		{
+			// Only search from tiles the MovementType can stand on.
+			continue;
+		}
+
+		// Search the whole Map for the best cost to the goal.
+		Map::SearchSources sources( 1 );
+		sources[ 0 ].tilePos = originPos;
+		sources[ 0 ].movementRange = ( MAP_WIDTH * MAP_HEIGHT * 100 );
+		map.FindReachableTilesFromSources( movementType, sources, context );
+
+		size_t goalIndex = map.GetCompactTileIndex( goalPos );
+		bool isReachable = context.GetReachedTiles().Contains( goalIndex );
+		int bestCost = ( isReachable ? context.GetBestTotalCostToEnter( goalIndex ) : -1 );
+
+		// Find the same path using the cluster graph.
+		Path path;
+		bool isFound = map.FindHierarchicalPath( movementType, originPos, goalPos, path );
+		CHECK( isFound == isReachable );
+
+		if( isFound && isReachable )
+		{
+			int cost = GetPathCost( map, movementCosts, originPos, goalPos, path );
+			int allowedDetour = ( DETOUR_PER_CLUSTER * GetClustersCrossed( path, originPos ) );
+			CHECK( cost >= bestCost );
+			CHECK( cost <= bestCost + allowedDetour );
+
+			++foundCount;
+			optimalCount += ( cost == bestCost ? 1 : 0 );
+		}
+	}
+
+	std::printf( "%d paths found, %d of them optimal\n", foundCount, optimalCount );
+	CHECK( foundCount > 0 );
+	return TestUtil::GetExitCode();
+}
@@ -0,0 +1,108 @@
+#include "TestUtil.h"
+
+#include <vector>
+
+using namespace mage;
+
+namespace
+{
+	const int ROLL_COUNT = 64;
+
+
+	/**
+	 * Rolls a mix of raw values and damage-style rolls from a Game's random stream.
+	 */
+	std::vector< int > Roll( Game& game )
+	{
+		std::vector< int > result;
+
+		for( int i = 0; i < ROLL_COUNT; ++i )
+		{
+			result.push_back( ( i % 2 == 0 ) ? (int) ( game.GetRandom().Next() & 0x7fffffff ) : game.GetRandom().RandomInRange( 0, 9 ) );
+		}
+
+		return result;
+	}
+}
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	Map map;
+	map.Init( &scenario );
+	map.Resize( 6, 6 );
+	map.FillWithDefaultTerrainType();
+	map.CreateFaction();
+	map.CreateFaction();
+
+	// Games seeded the same way roll the same values.
+	Game firstGame;
+	firstGame.Init( &map );
+	firstGame.SetRandomSeed( 1234 );
+
+	Game secondGame;
+	secondGame.Init( &map );
+	secondGame.SetRandomSeed( 1234 );
+
+	Game otherGame;
+	otherGame.Init( &map );
+	otherGame.SetRandomSeed( 4321 );
+
+	std::vector< int > firstRolls = Roll( firstGame );
+	CHECK( firstRolls == Roll( secondGame ) );
+	CHECK( firstRolls != Roll( otherGame ) );
+
+	// Streams with the same seed but different stream indices are independent.
+	RandomStream firstStream( 1234, 1 );
+	RandomStream secondStream( 1234, 2 );
+	int matchCount = 0;
+
+	for( int i = 0; i < ROLL_COUNT; ++i )
+	{
+		matchCount += ( firstStream.Next() == secondStream.Next() ? 1 : 0 );
+	}
+
+	CHECK( matchCount < ROLL_COUNT );
+
+	// Save the Game partway through, and write the state out as text.
+	rapidjson::Document state;
+	state.SetObject();
+	firstGame.SaveState( state );
+	CHECK( state.HasMember( "random" ) );
+	CHECK( state.HasMember( "map" ) && state[ "map" ].IsObject() && state[ "map" ].HasMember( "units" ) );
+
+	rapidjson::StringBuffer buffer;
+	rapidjson::Writer< rapidjson::StringBuffer > writer( buffer );
+	state.Accept( writer );
+
+	// Load the state into a fresh Game (whose stream starts from a different seed).
+	Map loadedMap;
+	loadedMap.Init( &scenario );
+	loadedMap.Resize( 6, 6 );
+	loadedMap.FillWithDefaultTerrainType();
+	loadedMap.CreateFaction();
+	loadedMap.CreateFaction();
+
+	rapidjson::Document loadedState;
+	loadedState.Parse< 0 >( buffer.GetString() );
+	CHECK( !loadedState.HasParseError() );
+
+	Game loadedGame;
+	loadedGame.Init( &loadedMap );
+	loadedGame.SetRandomSeed( 99 );
+	loadedGame.LoadState( loadedState );
+
+	// The loaded Game continues exactly where the saved one left off.
+	CHECK( loadedGame.GetRandom().GetState() == firstGame.GetRandom().GetState() );
+	CHECK( loadedGame.GetRandom().GetIncrement() == firstGame.GetRandom().GetIncrement() );
+	CHECK( Roll( loadedGame ) == Roll( firstGame ) );
+
+	return TestUtil::GetExitCode();
+}
@@ -0,0 +1,154 @@
+#include "TestUtil.h"
+
+using namespace mage;
+
+namespace
+{
+	const int ROLLOUT_COUNT = 64;
+	const int MAX_TURN_COUNT = 60;
+	const uint64 SEED = 11;
+
+
+	/**
+	 * Checks that a snapshot holds the same Units, tiles and funds as the Game it was captured from.
+	 */
+	void CheckSnapshotMatchesGame( const GameSnapshot& snapshot, Game& game )
+	{
+		Map* map = game.GetMap();
+		const Map::Factions& factions = map->GetFactions();
+		CHECK( snapshot.GetWidth() == map->GetWidth() && snapshot.GetHeight() == map->GetHeight() );
+		CHECK( snapshot.GetFactionCount() == (int) factions.size() );
+		CHECK( snapshot.GetPlayerCount() == (int) game.GetPlayerCount() );
+
+		for( size_t i = 0; i < factions.size(); ++i )
+		{
+			CHECK( snapshot.GetFunds( (int) i ) == factions[ i ]->GetFunds() );
+			CHECK( snapshot.CalculateIncome( (int) i ) == factions[ i ]->CalculateIncome() );
+		}
+
+		for( short y = 0; y < map->GetHeight(); ++y )
+		{
+			for( short x = 0; x < map->GetWidth(); ++x )
+			{
+				Map::Iterator tile = map->GetTile( x, y );
+				size_t tileIndex = snapshot.GetTileIndex( x, y );
+				short ownerIndex = snapshot.GetTileOwnerIndex( tileIndex );
+				CHECK( snapshot.GetTerrainTypeID( tileIndex ) == (short) tile->GetTerrainType()->GetID() );
+				CHECK( ownerIndex == GameSnapshot::NO_FACTION ? !tile->HasOwner() : tile->GetOwner() == factions[ ownerIndex ] );
+
+				// Each occupied tile holds a Unit in the snapshot with the same state as the live Unit.
+				short unitIndex = snapshot.GetTileUnitIndex( tileIndex );
+				CHECK( ( unitIndex != GameSnapshot::NO_UNIT ) == tile->IsOccupied() );
+
+				if( unitIndex != GameSnapshot::NO_UNIT && tile->IsOccupied() )
+				{
+					const GameSnapshot::UnitState& state = snapshot.GetUnit( unitIndex );
+					const Unit* unit = tile->GetUnit();
+					CHECK( state.isAlive && unit->IsAlive() );
+					CHECK( state.tileX == x && state.tileY == y );
+					CHECK( state.unitTypeID == (short) unit->GetUnitType()->GetID() );
+					CHECK( factions[ state.ownerIndex ] == unit->GetOwner() );
+					CHECK( state.health == unit->GetHealth() );
+					CHECK( state.ammo == unit->GetAmmo() );
+					CHECK( state.supplies == unit->GetSupplies() );
+					CHECK( state.isActive == unit->IsActive() );
+				}
+			}
+		}
+	}
+
+
+	bool AreResultsEqual( const RolloutEngine::Result& first, const RolloutEngine::Result& second )
+	{
+		return ( first.winCounts == second.winCounts && first.drawCount == second.drawCount && first.rolloutCount == second.rolloutCount );
+	}
+}
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	Map map;
+	map.Init( &scenario );
+	map.Resize( 12, 10 );
+	map.FillWithDefaultTerrainType();
+
+	TerrainType* cityType = scenario.TerrainTypes.FindByName( "City" );
+	TestUtil::SetTerrain( map, 1, 1, cityType );
+	TestUtil::SetTerrain( map, 10, 8, cityType );
+	TestUtil::SetTerrain( map, 6, 5, cityType );
+	map.FlushChangedTiles();
+
+	Faction* firstFaction = map.CreateFaction();
+	Faction* secondFaction = map.CreateFaction();
+	map.GetTile( 1, 1 )->SetOwner( firstFaction );
+	map.GetTile( 10, 8 )->SetOwner( secondFaction );
+	firstFaction->SetFunds( 1000 );
+	secondFaction->SetFunds( 500 );
+
+	UnitType* tankType = scenario.UnitTypes.FindByName( "MediumTank" );
+	UnitType* infantryType = scenario.UnitTypes.FindByName( "Infantry" );
+	CHECK( tankType->GetAttackRange().Min == 1 && tankType->GetAttackRange().Max == 1 );
+	map.CreateUnit( tankType, firstFaction, 2, 2 );
+	map.CreateUnit( infantryType, firstFaction, 1, 1, 6 );
+	map.CreateUnit( tankType, secondFaction, 9, 7, 8 );
+	map.CreateUnit( infantryType, secondFaction, 10, 8 );
+
+	// A dead Unit must not be captured (and its tile must be free).
+	Unit* deadUnit = map.CreateUnit( infantryType, secondFaction, 6, 5 );
+	deadUnit->Die();
+
+	Game game;
+	game.Init( &map );
+	game.SetRandomSeed( 5 );
+	game.CreatePlayer( firstFaction );
+	game.CreatePlayer( secondFaction );
+	game.Start();
+
+	GameSnapshot snapshot;
+	snapshot.Capture( &game );
+	CheckSnapshotMatchesGame( snapshot, game );
+	CHECK( snapshot.GetUnitCount() == 4 );
+
+	// The results only depend on the seed, not on the number of workers.
+	RolloutEngine engine;
+	engine.SetMaxTurnCount( MAX_TURN_COUNT );
+
+	RolloutEngine::Result singleWorkerResult;
+	engine.SetWorkerCount( 1 );
+	engine.Run( snapshot, ROLLOUT_COUNT, SEED, singleWorkerResult );
+
+	RolloutEngine::Result multipleWorkerResult;
+	engine.SetWorkerCount( 4 );
+	CHECK( engine.GetWorkerCount() == 4 );
+	engine.Run( snapshot, ROLLOUT_COUNT, SEED, multipleWorkerResult );
+
+	RolloutEngine::Result repeatedResult;
+	engine.Run( snapshot, ROLLOUT_COUNT, SEED, repeatedResult );
+
+	CHECK( AreResultsEqual( singleWorkerResult, multipleWorkerResult ) );
+	CHECK( AreResultsEqual( multipleWorkerResult, repeatedResult ) );
+	CHECK( singleWorkerResult.rolloutCount == ROLLOUT_COUNT );
+	CHECK( (int) singleWorkerResult.winCounts.size() == snapshot.GetFactionCount() );
+
+	int totalCount = singleWorkerResult.drawCount;
+
+	for( auto it = singleWorkerResult.winCounts.begin(); it != singleWorkerResult.winCounts.end(); ++it )
+	{
+		totalCount += *it;
+	}
+
+	CHECK( totalCount == ROLLOUT_COUNT );
+	std::printf( "Rollouts: %d wins, %d wins, %d draws\n", singleWorkerResult.winCounts[ 0 ], singleWorkerResult.winCounts[ 1 ], singleWorkerResult.drawCount );
+
+	// Running rollouts never changes the snapshot they start from.
+	CheckSnapshotMatchesGame( snapshot, game );
+
+	return TestUtil::GetExitCode();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * Minimal helpers shared by the host tests. Each test is a small program that returns a non-zero exit code when a
+ * check fails, so that CTest can run it without a test framework.
+ */
+
+#include "androidwars_sim.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+// Report a failed check and count it, but keep running so that one run shows every failure.
+#define CHECK( condition ) \
+	do \
+	{ \
+		if( !( condition ) ) \
+		{ \
+			std::printf( "%s(%d): CHECK( %s ) failed\n", __FILE__, __LINE__, #condition ); \
+			++TestUtil::GetFailureCount(); \
+		} \
+	} \
+	while( false )
+
+namespace TestUtil
+{
+	inline int& GetFailureCount()
+	{
+		static int failureCount = 0;
+		return failureCount;
+	}
+
+
+	inline int GetExitCode()
+	{
+		int failureCount = GetFailureCount();
+
+		if( failureCount > 0 )
+		{
+			std::printf( "%d check(s) failed\n", failureCount );
+		}
+
+		return ( failureCount > 0 ? 1 : 0 );
+	}
+
+
+	inline bool LoadScenario( mage::Scenario& scenario )
+	{
+		// Read the data the app ships with (ANDROIDWARS_DATA_PATH is set by CMakeLists.txt).
+		std::ifstream file( ANDROIDWARS_DATA_PATH );
+
+		if( !file )
+		{
+			std::printf( "Could not open scenario data \"%s\"!\n", ANDROIDWARS_DATA_PATH );
+			return false;
+		}
+
+		std::stringstream data;
+		data << file.rdbuf();
+		scenario.LoadDataFromString( data.str() );
+		return true;
+	}
+
+
+	inline void SetTerrain( mage::Map& map, short tileX, short tileY, mage::TerrainType* terrainType )
+	{
+		mage::Map::Iterator tile = map.GetTile( tileX, tileY );
+		tile->SetTerrainType( terrainType );
+	}
+}
@@ -0,0 +1,64 @@
+#include "TestUtil.h"
+
+using namespace mage;
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	Map map;
+	map.Init( &scenario );
+	map.Resize( 16, 12 );
+	map.FillWithDefaultTerrainType();
+
+	Faction* faction = map.CreateFaction();
+	Faction* enemyFaction = map.CreateFaction();
+	UnitType* tankType = scenario.UnitTypes.FindByName( "MediumTank" );
+	Unit* enemyUnit = map.CreateUnit( tankType, enemyFaction, 3, 3 );
+	Unit* otherEnemyUnit = map.CreateUnit( tankType, enemyFaction, 14, 10 );
+	Vec2s nearPos( 4, 3 );
+	Vec2s farPos( 14, 9 );
+
+	ThreatMap threatMap;
+	threatMap.Build( &map, faction );
+	CHECK( threatMap.IsThreatened( nearPos ) );
+	CHECK( threatMap.IsThreatened( farPos ) );
+	CHECK( threatMap.IsThreatened( Vec2s( 1, 2 ) ) );
+
+	// A Unit that changes sides no longer threatens the Faction.
+	enemyUnit->SetOwner( faction );
+	threatMap.RefreshUnit( enemyUnit );
+	CHECK( !threatMap.IsThreatened( Vec2s( 1, 2 ) ) );
+	CHECK( threatMap.IsThreatened( farPos ) );
+
+	// A Unit that changes sides back threatens it again.
+	enemyUnit->SetOwner( enemyFaction );
+	threatMap.RefreshUnit( enemyUnit );
+	CHECK( threatMap.IsThreatened( Vec2s( 1, 2 ) ) );
+
+	// A dead Unit doesn't threaten anything.
+	otherEnemyUnit->Die();
+	threatMap.RefreshUnit( otherEnemyUnit );
+	CHECK( !threatMap.IsThreatened( Vec2s( 15, 11 ) ) );
+	CHECK( threatMap.IsThreatened( nearPos ) );
+
+	// Refreshing a Unit matches building the ThreatMap from scratch.
+	ThreatMap rebuiltThreatMap;
+	rebuiltThreatMap.Build( &map, faction );
+
+	for( short y = 0; y < map.GetHeight(); ++y )
+	{
+		for( short x = 0; x < map.GetWidth(); ++x )
+		{
+			CHECK( threatMap.GetThreatCount( Vec2s( x, y ) ) == rebuiltThreatMap.GetThreatCount( Vec2s( x, y ) ) );
+		}
+	}
+
+	return TestUtil::GetExitCode();
+}
@@ -0,0 +1,157 @@
+#include "TestUtil.h"
+
+using namespace mage;
+
+namespace
+{
+	const int SUPPLIES_CONSUMED_PER_TURN = 5;
+
+
+	/**
+	 * Loads the shipped data, but makes Units with Tires burn supplies every turn and die when they run out.
+	 */
+	bool LoadScenarioWithStarvation( Scenario& scenario )
+	{
+		std::ifstream file( ANDROIDWARS_DATA_PATH );
+
+		if( !file )
+		{
+			std::printf( "Could not open scenario data \"%s\"!\n", ANDROIDWARS_DATA_PATH );
+			return false;
+		}
+
+		std::stringstream data;
+		data << file.rdbuf();
+
+		rapidjson::Document document;
+		document.Parse< 0 >( data.str().c_str() );
+
+		if( document.HasParseError() || !document.HasMember( "MovementTypes" ) )
+		{
+			std::printf( "Could not parse scenario data \"%s\"!\n", ANDROIDWARS_DATA_PATH );
+			return false;
+		}
+
+		rapidjson::Value& movementTypes = document[ "MovementTypes" ];
+
+		for( auto it = movementTypes.Begin(); it != movementTypes.End(); ++it )
+		{
+			if( std::string( ( *it )[ "name" ].GetString() ) == "Tires" )
+			{
+				it->AddMember( "suppliesConsumedPerTurn", SUPPLIES_CONSUMED_PER_TURN, document.GetAllocator() );
+				it->AddMember( "requiresSuppliesToSurvive", true, document.GetAllocator() );
+			}
+		}
+
+		scenario.LoadDataFromJSON( document );
+		return true;
+	}
+
+
+	/**
+	 * Counts how many times a Unit's stats changed.
+	 */
+	struct StatsChangedCounter
+	{
+		StatsChangedCounter( Unit* unit ) :
+			count( 0 )
+		{
+			unit->OnStatsChanged.AddCallback( [this]() { ++count; } );
+		}
+
+		int count;
+	};
+}
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !LoadScenarioWithStarvation( scenario ) )
+	{
+		return 1;
+	}
+
+	UnitType* tankType = scenario.UnitTypes.FindByName( "MediumTank" );
+	UnitType* infantryType = scenario.UnitTypes.FindByName( "Infantry" );
+	CHECK( tankType->GetMovementType()->GetSuppliesConsumedPerTurn() == SUPPLIES_CONSUMED_PER_TURN );
+	CHECK( tankType->GetMovementType()->RequiresSuppliesToSurvive() );
+	CHECK( !infantryType->GetMovementType()->RequiresSuppliesToSurvive() );
+
+	Map map;
+	map.Init( &scenario );
+	map.Resize( 8, 8 );
+	map.FillWithDefaultTerrainType();
+
+	TerrainType* cityType = scenario.TerrainTypes.FindByName( "City" );
+	TestUtil::SetTerrain( map, 1, 1, cityType );
+	TestUtil::SetTerrain( map, 2, 1, cityType );
+	TestUtil::SetTerrain( map, 3, 1, cityType );
+	TestUtil::SetTerrain( map, 4, 4, cityType );
+	TestUtil::SetTerrain( map, 6, 1, cityType );
+	map.FlushChangedTiles();
+
+	Faction* faction = map.CreateFaction();
+	Faction* enemyFaction = map.CreateFaction();
+	map.GetTile( 1, 1 )->SetOwner( faction );
+	map.GetTile( 2, 1 )->SetOwner( faction );
+	map.GetTile( 3, 1 )->SetOwner( faction );
+	map.GetTile( 6, 1 )->SetOwner( enemyFaction );
+
+	// Units on tiles owned by their Faction are repaired and resupplied.
+	Unit* damagedInfantry = map.CreateUnit( infantryType, faction, 1, 1, 6 );
+	Unit* healthyInfantry = map.CreateUnit( infantryType, faction, 2, 1 );
+	Unit* hungryTank = map.CreateUnit( tankType, faction, 3, 1, 7, -1, 3 );
+
+	// Units on tiles the Faction does not own only use up supplies.
+	Unit* neutralTank = map.CreateUnit( tankType, faction, 4, 4, 7, -1, 30 );
+	Unit* idleInfantry = map.CreateUnit( infantryType, faction, 5, 5, 4 );
+	Unit* starvingTank = map.CreateUnit( tankType, faction, 6, 6, -1, -1, 3 );
+
+	// Units of other Factions are not touched.
+	Unit* enemyTank = map.CreateUnit( tankType, enemyFaction, 6, 1, 5, -1, 3 );
+
+	StatsChangedCounter damagedInfantryCounter( damagedInfantry );
+	StatsChangedCounter healthyInfantryCounter( healthyInfantry );
+	StatsChangedCounter hungryTankCounter( hungryTank );
+	StatsChangedCounter neutralTankCounter( neutralTank );
+	StatsChangedCounter idleInfantryCounter( idleInfantry );
+	StatsChangedCounter starvingTankCounter( starvingTank );
+	StatsChangedCounter enemyTankCounter( enemyTank );
+
+	// Starting the Game starts the first Faction's turn.
+	Game game;
+	game.Init( &map );
+	game.CreatePlayer( faction );
+	game.CreatePlayer( enemyFaction );
+	game.Start();
+
+	CHECK( damagedInfantry->GetHealth() == 6 + Unit::REPAIR_AMOUNT );
+	CHECK( damagedInfantryCounter.count == 1 );
+	CHECK( healthyInfantry->GetHealth() == Unit::MAX_HEALTH );
+	CHECK( healthyInfantryCounter.count == 0 );
+	CHECK( hungryTank->IsAlive() );
+	CHECK( hungryTank->GetHealth() == 7 + Unit::REPAIR_AMOUNT );
+	CHECK( hungryTank->GetSupplies() == tankType->GetMaxSupplies() );
+	CHECK( hungryTankCounter.count == 1 );
+
+	CHECK( neutralTank->IsAlive() );
+	CHECK( neutralTank->GetHealth() == 7 );
+	CHECK( neutralTank->GetSupplies() == 30 - SUPPLIES_CONSUMED_PER_TURN );
+	CHECK( neutralTankCounter.count == 1 );
+	CHECK( idleInfantry->GetHealth() == 4 );
+	CHECK( idleInfantryCounter.count == 0 );
+
+	// A Unit that runs out of supplies dies (and frees its tile).
+	CHECK( starvingTank->IsDead() );
+	CHECK( starvingTank->GetSupplies() == 0 );
+	CHECK( starvingTankCounter.count == 1 );
+	CHECK( map.GetTile( 6, 6 )->IsEmpty() );
+
+	CHECK( enemyTank->GetHealth() == 5 );
+	CHECK( enemyTank->GetSupplies() == 3 );
+	CHECK( enemyTankCounter.count == 0 );
+
+	return TestUtil::GetExitCode();
+}
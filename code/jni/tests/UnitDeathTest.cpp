@@ -0,0 +1,48 @@
+#include "TestUtil.h"
+
+using namespace mage;
+
+
+int main()
+{
+	Scenario scenario;
+
+	if( !TestUtil::LoadScenario( scenario ) )
+	{
+		return 1;
+	}
+
+	Map map;
+	map.Init( &scenario );
+	map.Resize( 8, 8 );
+	map.FillWithDefaultTerrainType();
+
+	// The MediumTank (2 movement per plain, range 6) can only reach (4,5) through the enemy Infantry's tile.
+	Faction* faction = map.CreateFaction();
+	Faction* enemyFaction = map.CreateFaction();
+	Unit* tank = map.CreateUnit( scenario.UnitTypes.FindByName( "MediumTank" ), faction, 2, 5 );
+	Unit* enemy = map.CreateUnit( scenario.UnitTypes.FindByName( "Infantry" ), enemyFaction, 3, 5 );
+	Vec2s goalPos( 4, 5 );
+	size_t goalIndex = map.GetCompactTileIndex( goalPos );
+
+	Path path;
+	CHECK( !map.FindReachableTiles( tank ).Contains( goalIndex ) );
+	map.FindBestPathToTile( tank, goalPos, path );
+	CHECK( !path.IsValid() );
+
+	SearchContext context;
+	map.FindReachableTiles( tank, context );
+	CHECK( map.IsSearchCurrent( context, tank ) );
+
+	// Killing the enemy frees its tile and drops the searches that were blocked by it.
+	enemy->Die();
+	CHECK( map.GetTile( 3, 5 )->IsEmpty() );
+	CHECK( !map.IsSearchCurrent( context, tank ) );
+
+	map.FindBestPathToTile( tank, goalPos, path );
+	CHECK( path.IsValid() && path.GetLength() == 2 );
+	CHECK( path.GetDestination() == goalPos );
+	CHECK( map.FindReachableTiles( tank ).Contains( goalIndex ) );
+
+	return TestUtil::GetExitCode();
+}
@@ -16,8 +16,10 @@ namespace mage
 		 */
 		struct Callable
 		{
+			virtual ~Callable() { }
 			virtual ReturnType Invoke( ParameterTypes... parameters ) const = 0;
-			virtual Callable* Clone() const = 0;
+			virtual Callable* Clone( void* buffer ) const = 0;
+			virtual Callable* MoveInline( void* buffer ) = 0;
 			virtual bool operator==( const Callable& other ) const = 0;
 		};
 
@@ -27,21 +29,36 @@ namespace mage
 		template< typename Function >
 		struct FunctionWrapper : public Callable
 		{
-			FunctionWrapper( Function function ) :
+			FunctionWrapper( const Function& function ) :
 				function( function )
 			{ }
 
+			FunctionWrapper( Function&& function ) :
+				function( static_cast< Function&& >( function ) )
+			{ }
+
 			virtual ReturnType Invoke( ParameterTypes... parameters ) const
 			{
 				return function( parameters... );
 			}
 
 			/**
-			 * Creates and returns a new wrapper of the same type around the same internal function or lambda.
+			 * Creates and returns a new wrapper of the same type around the same internal function or lambda
+			 * (stored in the buffer if it fits).
+			 */
+			virtual Callable* Clone( void* buffer ) const
+			{
+				return Create< FunctionWrapper< Function > >( buffer, function );
+			}
+
+			/**
+			 * Moves this inline-stored wrapper into another buffer and destroys the original.
 			 */
-			virtual Callable* Clone() const
+			virtual Callable* MoveInline( void* buffer )
 			{
-				return new FunctionWrapper< Function >( function );
+				Callable* result = new( buffer ) FunctionWrapper< Function >( static_cast< Function&& >( function ) );
+				this->~FunctionWrapper();
+				return result;
 			}
 
 			virtual bool operator==( const Callable& other ) const
@@ -71,11 +88,22 @@ namespace mage
 			}
 
 			/**
-			 * Creates and returns a new wrapper of the same type around the same internal object and method.
+			 * Creates and returns a new wrapper of the same type around the same internal object and method
+			 * (stored in the buffer if it fits).
 			 */
-			virtual Callable* Clone() const
+			virtual Callable* Clone( void* buffer ) const
 			{
-				return new MethodWrapper< Callee, Method >( callee, method );
+				return Create< MethodWrapper< Callee, Method > >( buffer, callee, method );
+			}
+
+			/**
+			 * Moves this inline-stored wrapper into another buffer and destroys the original.
+			 */
+			virtual Callable* MoveInline( void* buffer )
+			{
+				Callable* result = new( buffer ) MethodWrapper< Callee, Method >( callee, method );
+				this->~MethodWrapper();
+				return result;
 			}
 
 			virtual bool operator==( const Callable& other ) const
@@ -88,23 +116,61 @@ namespace mage
 			Method method;
 		};
 
+		/**
+		 * Storage for small function wrappers, so that most Delegates don't need to allocate.
+		 */
+		union InlineStorage
+		{
+			void* pointer;
+			double number;
+			char bytes[ 4 * sizeof( void* ) ];
+		};
+
+		/**
+		 * Creates a wrapper in the inline buffer if it fits, or on the heap otherwise.
+		 */
+		template< class Wrapper, typename... Arguments >
+		static Callable* Create( void* buffer, Arguments&&... arguments )
+		{
+			if( sizeof( Wrapper ) <= sizeof( InlineStorage ) && alignof( Wrapper ) <= alignof( InlineStorage ) )
+			{
+				return new( buffer ) Wrapper( static_cast< Arguments&& >( arguments )... );
+			}
+			else
+			{
+				return new Wrapper( static_cast< Arguments&& >( arguments )... );
+			}
+		}
+
 	public:
 		/**
 		 * Default constructor that wraps an invalid (i.e. null) function.
 		 */
 		Delegate() :
 			mWrapper( nullptr )
-		{
-			//DebugPrintf( "Created Delegate wrapping 0x%x!", mWrapper );
-		}
+		{ }
 
 		/**
 		 * Copy constructor that clones another Delegate.
 		 */
 		Delegate( const Delegate< ReturnType, ParameterTypes... >& other ) :
-			mWrapper( other.IsValid() ? other.mWrapper->Clone() : nullptr )
+			mWrapper( other.IsValid() ? other.mWrapper->Clone( &mStorage ) : nullptr )
+		{ }
+
+		/**
+		 * Copy constructor for non-const Delegates (prevents the templated constructor from wrapping the Delegate itself).
+		 */
+		Delegate( Delegate< ReturnType, ParameterTypes... >& other ) :
+			Delegate( static_cast< const Delegate< ReturnType, ParameterTypes... >& >( other ) )
+		{ }
+
+		/**
+		 * Move constructor that takes ownership of the function wrapper of another Delegate.
+		 */
+		Delegate( Delegate< ReturnType, ParameterTypes... >&& other ) :
+			mWrapper( nullptr )
 		{
-			//DebugPrintf( "Cloned Delegate wrapping 0x%x! (Clone wraps 0x%x.)", other.mWrapper, mWrapper );
+			MoveFrom( other );
 		}
 
 		/**
@@ -112,20 +178,17 @@ namespace mage
 		 */
 		template< typename Function >
 		Delegate( Function function ) :
-			mWrapper( new FunctionWrapper< Function >( function ) )
-		{
-			//DebugPrintf( "Created Delegate wrapping 0x%x!", mWrapper );
-		}
+			mWrapper( Create< FunctionWrapper< Function > >( &mStorage, static_cast< Function&& >( function ) ) )
+		{ }
 
 		/**
 		 * Templated constructor allowing the creation of a Delegate that wraps any valid function or lambda type.
 		 */
 		template< class Callee, typename Method >
 		Delegate( Callee* callee, Method method ) :
-			mWrapper( new MethodWrapper< Callee, Method >( callee, method ) )
+			mWrapper( Create< MethodWrapper< Callee, Method > >( &mStorage, callee, method ) )
 		{
 			assertion( callee, "Cannot create Delegate wrapping object method without a valid object!" );
-			//DebugPrintf( "Created Delegate wrapping 0x%x!", mWrapper );
 		}
 
 		/**
@@ -141,10 +204,14 @@ namespace mage
 		 */
 		void Clear()
 		{
-			if( mWrapper )
+			if( IsInline() )
+			{
+				// Destroy the internal function wrapper in place.
+				mWrapper->~Callable();
+			}
+			else if( mWrapper )
 			{
 				// Delete the internal function wrapper.
-				//DebugPrintf( "Deleting wrapper 0x%x...", mWrapper );
 				delete mWrapper;
 			}
 
@@ -165,11 +232,22 @@ namespace mage
 				if( other.IsValid() )
 				{
 					// If the other Delegate wraps a valid function, clone the internal function wrapper of the other object.
-					mWrapper = other.mWrapper->Clone();
+					mWrapper = other.mWrapper->Clone( &mStorage );
 				}
 			}
+		}
 
-			//DebugPrintf( "Cloned Delegate wrapping 0x%x! (Clone wraps 0x%x.)", other.mWrapper, mWrapper );
+		/**
+		 * Move assignment operator that takes ownership of the function wrapper of another Delegate.
+		 */
+		void operator=( Delegate< ReturnType, ParameterTypes... >&& other )
+		{
+			if( &other != this )
+			{
+				// Clear the function pointer and take the other Delegate's function.
+				Clear();
+				MoveFrom( other );
+			}
 		}
 
 		bool operator==( const Delegate& other ) const
@@ -196,8 +274,122 @@ namespace mage
 			return mWrapper->Invoke( parameters... );
 		}
 
+		/**
+		 * Invokes the internal function or lambda (so a Delegate can be passed to templated visitors like any function object).
+		 */
+		ReturnType operator()( ParameterTypes... parameters ) const
+		{
+			return Invoke( parameters... );
+		}
+
 	private:
+		/**
+		 * Returns true if the internal function wrapper is stored in the inline buffer.
+		 */
+		bool IsInline() const
+		{
+			return ( mWrapper == reinterpret_cast< const Callable* >( &mStorage ) );
+		}
+
+		void MoveFrom( Delegate< ReturnType, ParameterTypes... >& other )
+		{
+			if( other.IsInline() )
+			{
+				// If the other wrapper is stored inline, move it into this Delegate's buffer.
+				mWrapper = other.mWrapper->MoveInline( &mStorage );
+			}
+			else
+			{
+				// Otherwise, steal the pointer to the heap-allocated wrapper.
+				mWrapper = other.mWrapper;
+			}
+
+			other.mWrapper = nullptr;
+		}
+
 		Callable* mWrapper;
+		InlineStorage mStorage;
+	};
+
+
+	/**
+	 * Lightweight non-owning reference to a function, lambda or Delegate. Never allocates, so it is
+	 * suitable for synchronous visitor callbacks. The referenced callable must outlive the FunctionRef.
+	 */
+	template< typename ReturnType, typename... ParameterTypes >
+	class FunctionRef
+	{
+	public:
+		/**
+		 * Default constructor that references an invalid (i.e. null) function.
+		 */
+		FunctionRef() :
+			mCallable( nullptr ), mInvoker( nullptr )
+		{ }
+
+		/**
+		 * Creates a reference to a Delegate.
+		 */
+		FunctionRef( const Delegate< ReturnType, ParameterTypes... >& delegate ) :
+			mCallable( delegate.IsValid() ? &delegate : nullptr ),
+			mInvoker( &InvokeDelegate )
+		{ }
+
+		/**
+		 * Creates a reference to a plain function (the function pointer itself is stored, since it can't be referenced).
+		 */
+		FunctionRef( ReturnType (*function)( ParameterTypes... ) ) :
+			mCallable( function ? reinterpret_cast< const void* >( function ) : nullptr ),
+			mInvoker( &InvokeFunctionPointer )
+		{ }
+
+		/**
+		 * Templated constructor allowing the creation of a reference to any function or lambda type.
+		 */
+		template< typename Function >
+		FunctionRef( const Function& function ) :
+			mCallable( &function ),
+			mInvoker( &InvokeFunction< Function > )
+		{ }
+
+		/**
+		 * Returns true if the FunctionRef references a valid function.
+		 */
+		bool IsValid() const
+		{
+			return ( mCallable != nullptr );
+		}
+
+		/**
+		 * Invokes the referenced function.
+		 */
+		ReturnType Invoke( ParameterTypes... parameters ) const
+		{
+			assertion( IsValid(), "Cannot call FunctionRef because the referenced function is invalid!" );
+			return mInvoker( mCallable, parameters... );
+		}
+
+	private:
+		typedef ReturnType (*Invoker)( const void*, ParameterTypes... );
+
+		template< typename Function >
+		static ReturnType InvokeFunction( const void* callable, ParameterTypes... parameters )
+		{
+			return ( *static_cast< const Function* >( callable ) )( parameters... );
+		}
+
+		static ReturnType InvokeDelegate( const void* callable, ParameterTypes... parameters )
+		{
+			return static_cast< const Delegate< ReturnType, ParameterTypes... >* >( callable )->Invoke( parameters... );
+		}
+
+		static ReturnType InvokeFunctionPointer( const void* callable, ParameterTypes... parameters )
+		{
+			return reinterpret_cast< ReturnType (*)( ParameterTypes... ) >( callable )( parameters... );
+		}
+
+		const void* mCallable;
+		Invoker mInvoker;
 	};
 
 
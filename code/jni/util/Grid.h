@@ -24,6 +24,8 @@ namespace mage
 
 	/**
 	 * Data structure for storing information in a grid.
+	 * Tiles are stored in fixed-size chunks that are allocated as the Grid is resized, so memory
+	 * usage scales with the largest size of the Grid rather than its maximum possible size.
 	 */
 	template< typename TileType, size_t MaxSizePowerOfTwo >
 	class Grid
@@ -35,13 +37,14 @@ namespace mage
 		protected:
 			BasicIterator();
 			BasicIterator( GridType* grid, const Vec2s& tilePos = Vec2s( -1, -1 ) );
+			BasicIterator( GridType* grid, const Vec2s& tilePos, DataType* tileData );
 			~BasicIterator();
 
 		public:
-			typedef Delegate< void, const IteratorType& > ForEachAdjacentCallback;
-
 			IteratorType GetAdjacent( PrimaryDirection direction ) const;
-			void ForEachAdjacent( ForEachAdjacentCallback callback ) const;
+
+			template< typename Function >
+			void ForEachAdjacent( Function&& function ) const;
 
 			DataType& operator*() const;
 			DataType* operator->() const;
@@ -69,6 +72,9 @@ namespace mage
 		private:
 			GridType* mGrid;
 			Vec2s mTilePos;
+
+			// Tile data found by the Grid while looping over a chunk (or null to look it up when dereferenced).
+			DataType* mTileData;
 		};
 
 	public:
@@ -79,6 +85,10 @@ namespace mage
 			Iterator( MAGE_GRID* grid ) : MAGE_GRID_ITERATOR_BASE( grid ) { }
 			Iterator( MAGE_GRID* grid, const Vec2s& tilePos ) : MAGE_GRID_ITERATOR_BASE( grid, tilePos ) { }
 			Iterator( MAGE_GRID* grid, short x, short y ) : MAGE_GRID_ITERATOR_BASE( grid, Vec2s( x, y ) ) { }
+
+		private:
+			friend class Grid;
+			Iterator( MAGE_GRID* grid, const Vec2s& tilePos, TileType* tileData ) : MAGE_GRID_ITERATOR_BASE( grid, tilePos, tileData ) { }
 		};
 
 		class ConstIterator : public MAGE_GRID_CONST_ITERATOR_BASE
@@ -89,15 +99,23 @@ namespace mage
 			ConstIterator( const MAGE_GRID* grid, const Vec2s& tilePos ) : MAGE_GRID_CONST_ITERATOR_BASE( grid, tilePos ) { }
 			ConstIterator( const MAGE_GRID* grid, short x, short y ) : MAGE_GRID_CONST_ITERATOR_BASE( grid, Vec2s( x, y ) ) { }
 			ConstIterator( const Iterator& iterator ) : MAGE_GRID_CONST_ITERATOR_BASE( iterator.GetGrid(), iterator.GetPosition() ) { }
+
+		private:
+			friend class Grid;
+			ConstIterator( const MAGE_GRID* grid, const Vec2s& tilePos, const TileType* tileData ) : MAGE_GRID_CONST_ITERATOR_BASE( grid, tilePos, tileData ) { }
 		};
 
 		static const size_t MAX_SIZE_POWER_OF_TWO = MaxSizePowerOfTwo;
 		static const short MAX_SIZE = ( 1 << MAX_SIZE_POWER_OF_TWO );
 		static const size_t MAX_TILES = ( (size_t) MAX_SIZE * (size_t) MAX_SIZE );
 
+		static const size_t CHUNK_SIZE_POWER_OF_TWO = ( MaxSizePowerOfTwo < 5 ? MaxSizePowerOfTwo : 5 );
+		static const short CHUNK_SIZE = ( 1 << CHUNK_SIZE_POWER_OF_TWO );
+		static const size_t TILES_PER_CHUNK = ( (size_t) CHUNK_SIZE * (size_t) CHUNK_SIZE );
+		static const size_t MAX_CHUNKS_PER_ROW_POWER_OF_TWO = ( MAX_SIZE_POWER_OF_TWO - CHUNK_SIZE_POWER_OF_TWO );
+		static const size_t MAX_CHUNKS = ( MAX_TILES / TILES_PER_CHUNK );
+
 		typedef Delegate< void, const Vec2s&, const Vec2s& > OnResizeCallback;
-		typedef Delegate< void, const Iterator& > ForEachTileCallback;
-		typedef Delegate< void, const ConstIterator& > ForEachConstTileCallback;
 
 		static Vec2s GetAdjacentTilePos( short x, short y, PrimaryDirection direction );
 		static Vec2s GetAdjacentTilePos( const Vec2s& tilePos, PrimaryDirection direction );
@@ -106,6 +124,7 @@ namespace mage
 		~Grid();
 
 		static RectS GetMaxBounds();
+		RectS GetAllocatedBounds() const;
 		void Resize( const Vec2s& size );
 		void Resize( short x, short y );
 		short GetWidth() const;
@@ -121,15 +140,23 @@ namespace mage
 		Iterator GetTile( short x, short y );
 		ConstIterator GetTile( const Vec2s& tilePos ) const;
 		ConstIterator GetTile( short x, short y ) const;
+		Iterator GetTileByIndex( size_t tileIndex );
+		ConstIterator GetTileByIndex( size_t tileIndex ) const;
 		bool IsValidTilePos( const Vec2s& tilePos ) const;
 		bool IsValidTilePos( short x, short y ) const;
 
-		void ForEachTile( ForEachTileCallback callback );
-		void ForEachTile( ForEachConstTileCallback callback ) const;
-		void ForEachTileInArea( const RectS& area, ForEachTileCallback callback );
-		void ForEachTileInArea( const RectS& area, ForEachConstTileCallback ) const;
-		void ForEachTileInMaxArea( ForEachTileCallback callback );
-		void ForEachTileInMaxArea( ForEachConstTileCallback ) const;
+		template< typename Function >
+		void ForEachTile( Function&& function );
+		template< typename Function >
+		void ForEachTile( Function&& function ) const;
+		template< typename Function >
+		void ForEachTileInArea( const RectS& area, Function&& function );
+		template< typename Function >
+		void ForEachTileInArea( const RectS& area, Function&& function ) const;
+		template< typename Function >
+		void ForEachTileInMaxArea( Function&& function );
+		template< typename Function >
+		void ForEachTileInMaxArea( Function&& function ) const;
 
 		void Fill( const TileType& tile );
 		void Fill( const TileType& tile, const RectS& area );
@@ -137,28 +164,49 @@ namespace mage
 
 		static size_t GetTileIndex( const Vec2s& tilePos );
 		static size_t GetTileIndex( short x, short y );
+		static Vec2s GetTilePosFromIndex( size_t tileIndex );
 
 	private:
+		Grid( const MAGE_GRID& other );
+		MAGE_GRID& operator=( const MAGE_GRID& other );
+
+		static size_t GetChunkIndex( short x, short y );
+		static size_t GetIndexInChunk( short x, short y );
+
+		void AllocateChunks( short x, short y );
+		TileType& GetTileData( const Vec2s& tilePos );
+		const TileType& GetTileData( const Vec2s& tilePos ) const;
+
 		Vec2s mSize;
+		Vec2s mAllocatedChunkCount;
 
 	public:
 		Event< const Vec2f&, const Vec2f& > OnResize;
+		Event< const RectS& > OnChunkAllocated;
 
 	private:
 		std::vector< Unit* > mUnits;
-		TileType mTiles[ MAX_TILES ];
+		TileType* mChunks[ MAX_CHUNKS ];
 	};
 
 
 	MAGE_GRID_BASIC_ITERATOR_TEMPLATE
 	MAGE_GRID_BASIC_ITERATOR::BasicIterator() :
-		mGrid( nullptr ), mTilePos( -1, -1 )
+		mGrid( nullptr ), mTilePos( -1, -1 ), mTileData( nullptr )
 	{ }
 
 
 	MAGE_GRID_BASIC_ITERATOR_TEMPLATE
 	MAGE_GRID_BASIC_ITERATOR::BasicIterator( GridType* grid, const Vec2s& tilePos ) :
-		mGrid( grid ), mTilePos( tilePos )
+		mGrid( grid ), mTilePos( tilePos ), mTileData( nullptr )
+	{
+		assertion( mGrid, "Cannot create Grid iterator without a valid Grid reference!" );
+	}
+
+
+	MAGE_GRID_BASIC_ITERATOR_TEMPLATE
+	MAGE_GRID_BASIC_ITERATOR::BasicIterator( GridType* grid, const Vec2s& tilePos, DataType* tileData ) :
+		mGrid( grid ), mTilePos( tilePos ), mTileData( tileData )
 	{
 		assertion( mGrid, "Cannot create Grid iterator without a valid Grid reference!" );
 	}
@@ -176,7 +224,8 @@ namespace mage
 
 
 	MAGE_GRID_BASIC_ITERATOR_TEMPLATE
-	void MAGE_GRID_BASIC_ITERATOR::ForEachAdjacent( ForEachAdjacentCallback callback ) const
+	template< typename Function >
+	void MAGE_GRID_BASIC_ITERATOR::ForEachAdjacent( Function&& function ) const
 	{
 		for( size_t i = 0; i < PRIMARY_DIRECTION_COUNT; ++i )
 		{
@@ -186,8 +235,8 @@ namespace mage
 
 			if( adjacent.IsValid() )
 			{
-				// If the adjacent tile is valid, call the callback.
-				callback.Invoke( adjacent );
+				// If the adjacent tile is valid, call the function.
+				function( adjacent );
 			}
 		}
 	}
@@ -196,8 +245,14 @@ namespace mage
 	MAGE_GRID_BASIC_ITERATOR_TEMPLATE
 	DataType& MAGE_GRID_BASIC_ITERATOR::operator*() const
 	{
+		if( mTileData )
+		{
+			// Use the tile data found while looping over the Grid.
+			return *mTileData;
+		}
+
 		assertion( mGrid, "Cannot get data for Iterator without a valid Grid reference!" );
-		return mGrid->mTiles[ mGrid->GetTileIndex( mTilePos ) ];
+		return mGrid->GetTileData( mTilePos );
 	}
 
 
@@ -254,6 +309,7 @@ namespace mage
 	void MAGE_GRID_BASIC_ITERATOR::operator+=( const Vec2s& tileOffset )
 	{
 		mTilePos += tileOffset;
+		mTileData = nullptr;
 	}
 
 
@@ -261,6 +317,7 @@ namespace mage
 	void MAGE_GRID_BASIC_ITERATOR::operator-=( const Vec2s& tileOffset )
 	{
 		mTilePos -= tileOffset;
+		mTileData = nullptr;
 	}
 
 
@@ -336,12 +393,26 @@ namespace mage
 
 	MAGE_GRID_TEMPLATE
 	MAGE_GRID::Grid() :
-		mSize( 0, 0 )
-	{ }
+		mSize( 0, 0 ),
+		mAllocatedChunkCount( 0, 0 )
+	{
+		for( size_t i = 0; i < MAX_CHUNKS; ++i )
+		{
+			// Chunks are allocated on demand.
+			mChunks[ i ] = nullptr;
+		}
+	}
 
 
 	MAGE_GRID_TEMPLATE
-	MAGE_GRID::~Grid() { }
+	MAGE_GRID::~Grid()
+	{
+		for( size_t i = 0; i < MAX_CHUNKS; ++i )
+		{
+			// Destroy all allocated chunks.
+			delete[] mChunks[ i ];
+		}
+	}
 
 
 	MAGE_GRID_TEMPLATE
@@ -351,6 +422,13 @@ namespace mage
 	}
 
 
+	MAGE_GRID_TEMPLATE
+	RectS MAGE_GRID::GetAllocatedBounds() const
+	{
+		return RectS( 0, 0, mAllocatedChunkCount.x << CHUNK_SIZE_POWER_OF_TWO, mAllocatedChunkCount.y << CHUNK_SIZE_POWER_OF_TWO );
+	}
+
+
 	MAGE_GRID_TEMPLATE
 	void MAGE_GRID::Resize( const Vec2s& size )
 	{
@@ -363,6 +441,9 @@ namespace mage
 	{
 		assertion( IsValidSize( x, y ), "Cannot resize Map to invalid size (%d,%d)!", x, y );
 
+		// Make sure storage exists for every Tile in the new area.
+		AllocateChunks( x, y );
+
 		// Set the size of the map.
 		Vec2s oldSize( mSize );
 		mSize.Set( x, y );
@@ -458,6 +539,20 @@ namespace mage
 	}
 
 
+	MAGE_GRID_TEMPLATE
+	typename MAGE_GRID::Iterator MAGE_GRID::GetTileByIndex( size_t tileIndex )
+	{
+		return Iterator( this, GetTilePosFromIndex( tileIndex ) );
+	}
+
+
+	MAGE_GRID_TEMPLATE
+	typename MAGE_GRID::ConstIterator MAGE_GRID::GetTileByIndex( size_t tileIndex ) const
+	{
+		return ConstIterator( this, GetTilePosFromIndex( tileIndex ) );
+	}
+
+
 	MAGE_GRID_TEMPLATE
 	bool MAGE_GRID::IsValidTilePos( const Vec2s& tilePos ) const
 	{
@@ -473,70 +568,94 @@ namespace mage
 
 
 	MAGE_GRID_TEMPLATE
-	void MAGE_GRID::ForEachTile( ForEachTileCallback callback )
+	template< typename Function >
+	void MAGE_GRID::ForEachTile( Function&& function )
 	{
 		RectS area( 0, 0, mSize.x, mSize.y );
-		ForEachTileInArea( area, callback );
+		ForEachTileInArea( area, function );
 	}
 
 
 	MAGE_GRID_TEMPLATE
-	void MAGE_GRID::ForEachTile( ForEachConstTileCallback callback ) const
+	template< typename Function >
+	void MAGE_GRID::ForEachTile( Function&& function ) const
 	{
 		RectS area( 0, 0, mSize.x, mSize.y );
-		ForEachTileInArea( area, callback );
+		ForEachTileInArea( area, function );
 	}
 
 
 	MAGE_GRID_TEMPLATE
-	void MAGE_GRID::ForEachTileInArea( const RectS& area, ForEachTileCallback callback )
+	template< typename Function >
+	void MAGE_GRID::ForEachTileInArea( const RectS& area, Function&& function )
 	{
 		assertion( area.IsValid(), "Cannot run Tile callback on invalid area (%d,%d,%d,%d)!", area.Left, area.Top, area.Right, area.Bottom );
 		assertion( area.Left >= 0 && area.Top >= 0 && area.Right <= MAX_SIZE && area.Bottom <= MAX_SIZE, "Cannot run Tile callback on area (%d,%d,%d,%d) because it extends outside the max Grid bounds!", area.Left, area.Top, area.Right, area.Bottom );
-		assertion( callback.IsValid(), "Cannot run Tile callback on area (%d,%d,%d,%d) because the callback is invalid!", area.Left, area.Top, area.Right, area.Bottom );
 
 		for( short y = area.Top; y < area.Bottom; ++y )
 		{
-			for( short x = area.Left; x < area.Right; ++x )
+			for( short left = area.Left; left < area.Right; )
 			{
-				// Fire the callback for each Tile.
-				callback.Invoke( Iterator( this, x, y ) );
+				// Look up the chunk once for each run of the row that it contains, then walk its tile array.
+				short right = std::min( (short) ( ( left | ( CHUNK_SIZE - 1 ) ) + 1 ), area.Right );
+				TileType* chunk = mChunks[ GetChunkIndex( left, y ) ];
+				TileType* tiles = ( chunk ? &chunk[ GetIndexInChunk( left, y ) ] : nullptr );
+
+				for( short x = left; x < right; ++x )
+				{
+					// Call the function for each Tile.
+					function( Iterator( this, Vec2s( x, y ), ( tiles ? &tiles[ x - left ] : nullptr ) ) );
+				}
+
+				left = right;
 			}
 		}
 	}
 
 
 	MAGE_GRID_TEMPLATE
-	void MAGE_GRID::ForEachTileInArea( const RectS& area, ForEachConstTileCallback callback ) const
+	template< typename Function >
+	void MAGE_GRID::ForEachTileInArea( const RectS& area, Function&& function ) const
 	{
 		assertion( area.IsValid(), "Cannot run Tile callback on invalid area (%d,%d,%d,%d)!", area.Left, area.Top, area.Right, area.Bottom );
 		assertion( area.Left >= 0 && area.Top >= 0 && area.Right <= MAX_SIZE && area.Bottom <= MAX_SIZE, "Cannot run Tile callback on area (%d,%d,%d,%d) because it extends outside the max Grid bounds!", area.Left, area.Top, area.Right, area.Bottom );
-		assertion( callback.IsValid(), "Cannot run Tile callback on area (%d,%d,%d,%d) because the callback is invalid!", area.Left, area.Top, area.Right, area.Bottom );
 
 		for( short y = area.Top; y < area.Bottom; ++y )
 		{
-			for( short x = area.Left; x < area.Right; ++x )
+			for( short left = area.Left; left < area.Right; )
 			{
-				// Fire the callback for each Tile.
-				callback.Invoke( ConstIterator( this, x, y ) );
+				// Look up the chunk once for each run of the row that it contains, then walk its tile array.
+				short right = std::min( (short) ( ( left | ( CHUNK_SIZE - 1 ) ) + 1 ), area.Right );
+				const TileType* chunk = mChunks[ GetChunkIndex( left, y ) ];
+				const TileType* tiles = ( chunk ? &chunk[ GetIndexInChunk( left, y ) ] : nullptr );
+
+				for( short x = left; x < right; ++x )
+				{
+					// Call the function for each Tile.
+					function( ConstIterator( this, Vec2s( x, y ), ( tiles ? &tiles[ x - left ] : nullptr ) ) );
+				}
+
+				left = right;
 			}
 		}
 	}
 
 
 	MAGE_GRID_TEMPLATE
-	void MAGE_GRID::ForEachTileInMaxArea( ForEachTileCallback callback )
+	template< typename Function >
+	void MAGE_GRID::ForEachTileInMaxArea( Function&& function )
 	{
-		// Run the callback on every tile in the max area.
-		ForEachTileInArea( GetMaxBounds(), callback );
+		// Run the function on every tile that has storage allocated.
+		ForEachTileInArea( GetAllocatedBounds(), function );
 	}
 
 
 	MAGE_GRID_TEMPLATE
-	void MAGE_GRID::ForEachTileInMaxArea( ForEachConstTileCallback callback ) const
+	template< typename Function >
+	void MAGE_GRID::ForEachTileInMaxArea( Function&& function ) const
 	{
-		// Run the callback on every tile in the max area.
-		ForEachTileInArea( GetMaxBounds(), callback );
+		// Run the function on every tile that has storage allocated.
+		ForEachTileInArea( GetAllocatedBounds(), function );
 	}
 
 
@@ -564,7 +683,7 @@ namespace mage
 	{
 		ForEachTileInMaxArea( [ this, &tile ]( const Iterator& it )
 		{
-			// Fill each Tile in the max area.
+			// Fill each allocated Tile.
 			( *it ) = tile;
 		});
 	}
@@ -583,4 +702,75 @@ namespace mage
 		assertion( x >= 0 && x < MAX_SIZE && y >= 0 && y < MAX_SIZE, "Cannot get tile index for invalid tile position (%d,%d)!", x, y );
 		return ( ( y << MAX_SIZE_POWER_OF_TWO ) + x );
 	}
+
+
+	MAGE_GRID_TEMPLATE
+	Vec2s MAGE_GRID::GetTilePosFromIndex( size_t tileIndex )
+	{
+		assertion( tileIndex < MAX_TILES, "Cannot get tile position for invalid tile index (%d)!", tileIndex );
+		return Vec2s( (short) ( tileIndex & ( MAX_SIZE - 1 ) ), (short) ( tileIndex >> MAX_SIZE_POWER_OF_TWO ) );
+	}
+
+
+	MAGE_GRID_TEMPLATE
+	size_t MAGE_GRID::GetChunkIndex( short x, short y )
+	{
+		return ( ( ( y >> CHUNK_SIZE_POWER_OF_TWO ) << MAX_CHUNKS_PER_ROW_POWER_OF_TWO ) + ( x >> CHUNK_SIZE_POWER_OF_TWO ) );
+	}
+
+
+	MAGE_GRID_TEMPLATE
+	size_t MAGE_GRID::GetIndexInChunk( short x, short y )
+	{
+		return ( ( ( y & ( CHUNK_SIZE - 1 ) ) << CHUNK_SIZE_POWER_OF_TWO ) + ( x & ( CHUNK_SIZE - 1 ) ) );
+	}
+
+
+	MAGE_GRID_TEMPLATE
+	void MAGE_GRID::AllocateChunks( short x, short y )
+	{
+		// Determine the number of chunks needed to cover the area (chunks are never freed on shrink).
+		short chunkCountX = std::max( mAllocatedChunkCount.x, (short) ( ( x + CHUNK_SIZE - 1 ) >> CHUNK_SIZE_POWER_OF_TWO ) );
+		short chunkCountY = std::max( mAllocatedChunkCount.y, (short) ( ( y + CHUNK_SIZE - 1 ) >> CHUNK_SIZE_POWER_OF_TWO ) );
+		mAllocatedChunkCount.Set( chunkCountX, chunkCountY );
+
+		for( short chunkY = 0; chunkY < chunkCountY; ++chunkY )
+		{
+			for( short chunkX = 0; chunkX < chunkCountX; ++chunkX )
+			{
+				short left = ( chunkX << CHUNK_SIZE_POWER_OF_TWO );
+				short top = ( chunkY << CHUNK_SIZE_POWER_OF_TWO );
+				TileType*& chunk = mChunks[ GetChunkIndex( left, top ) ];
+
+				if( !chunk )
+				{
+					// Allocate the chunk and let listeners initialize the new Tiles.
+					chunk = new TileType[ TILES_PER_CHUNK ];
+					OnChunkAllocated.Invoke( RectS( left, top, left + CHUNK_SIZE, top + CHUNK_SIZE ) );
+				}
+			}
+		}
+	}
+
+
+	MAGE_GRID_TEMPLATE
+	TileType& MAGE_GRID::GetTileData( const Vec2s& tilePos )
+	{
+		assertion( tilePos.x >= 0 && tilePos.x < MAX_SIZE && tilePos.y >= 0 && tilePos.y < MAX_SIZE, "Cannot get tile data for invalid tile position (%d,%d)!", tilePos.x, tilePos.y );
+
+		TileType* chunk = mChunks[ GetChunkIndex( tilePos.x, tilePos.y ) ];
+		assertion( chunk, "Cannot get tile data for tile position (%d,%d) because it has not been allocated!", tilePos.x, tilePos.y );
+		return chunk[ GetIndexInChunk( tilePos.x, tilePos.y ) ];
+	}
+
+
+	MAGE_GRID_TEMPLATE
+	const TileType& MAGE_GRID::GetTileData( const Vec2s& tilePos ) const
+	{
+		assertion( tilePos.x >= 0 && tilePos.x < MAX_SIZE && tilePos.y >= 0 && tilePos.y < MAX_SIZE, "Cannot get tile data for invalid tile position (%d,%d)!", tilePos.x, tilePos.y );
+
+		const TileType* chunk = mChunks[ GetChunkIndex( tilePos.x, tilePos.y ) ];
+		assertion( chunk, "Cannot get tile data for tile position (%d,%d) because it has not been allocated!", tilePos.x, tilePos.y );
+		return chunk[ GetIndexInChunk( tilePos.x, tilePos.y ) ];
+	}
 }
@@ -0,0 +1,61 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Min-heap of integer indices (e.g. tile indices) that keeps track of the heap slot of each index,
+	 * allowing constant-time membership checks and logarithmic-time key updates.
+	 */
+	template< typename key_t >
+	class IndexedMinHeap
+	{
+	public:
+		typedef key_t Key;
+
+		static const int INVALID_SLOT = -1;
+
+		struct Pair
+		{
+			Pair();
+			Pair( const Key& key, size_t index );
+
+			bool operator>( const Pair& other ) const;
+
+			Key key;
+			size_t index;
+		};
+
+		IndexedMinHeap();
+		IndexedMinHeap( size_t indexCount );
+		~IndexedMinHeap();
+
+		void resize( size_t indexCount );
+		void insert( const Key& key, size_t index );
+		void update( const Key& key, size_t index );
+		Pair popMinNode();
+		size_t popMinIndex();
+		const Pair& peekMinNode() const;
+		size_t peekMinIndex() const;
+		bool hasIndex( size_t index ) const;
+		Key getKey( size_t index ) const;
+		void clear();
+
+		size_t getIndexCount() const;
+		size_t getSize() const;
+		bool isEmpty() const;
+
+	protected:
+		static size_t getParentSlot( size_t slot );
+		static size_t getFirstChildSlot( size_t slot );
+		static size_t getSecondChildSlot( size_t slot );
+
+		void setPair( size_t slot, const Pair& pair );
+		void bubbleUp( size_t slot );
+		void bubbleDown( size_t slot );
+
+		std::vector< Pair > m_pairs;
+		std::vector< int > m_slotsByIndex;
+	};
+}
+
+#include "IndexedMinHeap.inl"
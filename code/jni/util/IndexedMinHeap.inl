@@ -0,0 +1,287 @@
+#pragma once
+
+namespace mage
+{
+	template< typename key_t >
+	const int IndexedMinHeap< key_t >::INVALID_SLOT;
+
+
+	template< typename key_t >
+	IndexedMinHeap< key_t >::Pair::Pair() :
+		key(), index( 0 )
+	{ }
+
+
+	template< typename key_t >
+	IndexedMinHeap< key_t >::Pair::Pair( const Key& key, size_t index ) :
+		key( key ), index( index )
+	{ }
+
+
+	template< typename key_t >
+	bool IndexedMinHeap< key_t >::Pair::operator>( const Pair& other ) const
+	{
+		// Return whether this Pair has a greater key.
+		return ( key > other.key );
+	}
+
+
+	template< typename key_t >
+	IndexedMinHeap< key_t >::IndexedMinHeap()
+	{ }
+
+
+	template< typename key_t >
+	IndexedMinHeap< key_t >::IndexedMinHeap( size_t indexCount )
+	{
+		resize( indexCount );
+	}
+
+
+	template< typename key_t >
+	IndexedMinHeap< key_t >::~IndexedMinHeap() { }
+
+
+	template< typename key_t >
+	void IndexedMinHeap< key_t >::resize( size_t indexCount )
+	{
+		// Throw away the current contents of the heap.
+		m_pairs.clear();
+
+		// Allocate a slot entry for every index that can be stored in the heap.
+		m_slotsByIndex.assign( indexCount, INVALID_SLOT );
+		m_pairs.reserve( indexCount );
+	}
+
+
+	template< typename key_t >
+	void IndexedMinHeap< key_t >::insert( const Key& key, size_t index )
+	{
+		assertion( index < m_slotsByIndex.size(), "Cannot insert index %d into IndexedMinHeap with %d indices!", index, m_slotsByIndex.size() );
+		assertion( !hasIndex( index ), "Cannot insert index %d into IndexedMinHeap because it is already in the heap!", index );
+
+		// Add the element to the end of the array.
+		size_t slot = m_pairs.size();
+		m_pairs.push_back( Pair( key, index ) );
+		m_slotsByIndex[ index ] = (int) slot;
+
+		// Re-balance the tree.
+		bubbleUp( slot );
+	}
+
+
+	template< typename key_t >
+	void IndexedMinHeap< key_t >::update( const Key& key, size_t index )
+	{
+		if( hasIndex( index ) )
+		{
+			// If the index is in the heap, look up its slot directly.
+			size_t slot = (size_t) m_slotsByIndex[ index ];
+			Key oldKey = m_pairs[ slot ].key;
+			m_pairs[ slot ].key = key;
+
+			// Bubble the node up or down as necessary.
+			if( oldKey > key )
+			{
+				bubbleUp( slot );
+			}
+			else
+			{
+				bubbleDown( slot );
+			}
+		}
+	}
+
+
+	template< typename key_t >
+	typename IndexedMinHeap< key_t >::Pair IndexedMinHeap< key_t >::popMinNode()
+	{
+		assertion( !isEmpty(), "Cannot pop element from empty IndexedMinHeap!" );
+
+		// Copy the Pair to pop and forget its slot.
+		Pair result = m_pairs.front();
+		m_slotsByIndex[ result.index ] = INVALID_SLOT;
+
+		// Move the last element into the root and remove it from the end.
+		Pair last = m_pairs.back();
+		m_pairs.pop_back();
+
+		if( !m_pairs.empty() )
+		{
+			// Re-balance the tree.
+			setPair( 0, last );
+			bubbleDown( 0 );
+		}
+
+		// Return the popped value.
+		return result;
+	}
+
+
+	template< typename key_t >
+	size_t IndexedMinHeap< key_t >::popMinIndex()
+	{
+		return popMinNode().index;
+	}
+
+
+	template< typename key_t >
+	const typename IndexedMinHeap< key_t >::Pair& IndexedMinHeap< key_t >::peekMinNode() const
+	{
+		assertion( !isEmpty(), "Cannot peek element of empty IndexedMinHeap!" );
+		return m_pairs.front();
+	}
+
+
+	template< typename key_t >
+	size_t IndexedMinHeap< key_t >::peekMinIndex() const
+	{
+		return peekMinNode().index;
+	}
+
+
+	template< typename key_t >
+	bool IndexedMinHeap< key_t >::hasIndex( size_t index ) const
+	{
+		return ( index < m_slotsByIndex.size() && m_slotsByIndex[ index ] != INVALID_SLOT );
+	}
+
+
+	template< typename key_t >
+	typename IndexedMinHeap< key_t >::Key IndexedMinHeap< key_t >::getKey( size_t index ) const
+	{
+		assertion( hasIndex( index ), "Cannot get key of index %d because it is not in the IndexedMinHeap!", index );
+		return m_pairs[ m_slotsByIndex[ index ] ].key;
+	}
+
+
+	template< typename key_t >
+	void IndexedMinHeap< key_t >::clear()
+	{
+		for( size_t i = 0; i < m_pairs.size(); ++i )
+		{
+			// Only reset the slots that are in use, so clearing is proportional to the size of the heap.
+			m_slotsByIndex[ m_pairs[ i ].index ] = INVALID_SLOT;
+		}
+
+		// Reset the array.
+		m_pairs.clear();
+	}
+
+
+	template< typename key_t >
+	size_t IndexedMinHeap< key_t >::getIndexCount() const
+	{
+		return m_slotsByIndex.size();
+	}
+
+
+	template< typename key_t >
+	size_t IndexedMinHeap< key_t >::getSize() const
+	{
+		return m_pairs.size();
+	}
+
+
+	template< typename key_t >
+	bool IndexedMinHeap< key_t >::isEmpty() const
+	{
+		return m_pairs.empty();
+	}
+
+
+	template< typename key_t >
+	size_t IndexedMinHeap< key_t >::getParentSlot( size_t slot )
+	{
+		return ( ( slot - 1 ) >> 1 );
+	}
+
+
+	template< typename key_t >
+	size_t IndexedMinHeap< key_t >::getFirstChildSlot( size_t slot )
+	{
+		return ( ( slot << 1 ) + 1 );
+	}
+
+
+	template< typename key_t >
+	size_t IndexedMinHeap< key_t >::getSecondChildSlot( size_t slot )
+	{
+		return ( ( slot << 1 ) + 2 );
+	}
+
+
+	template< typename key_t >
+	void IndexedMinHeap< key_t >::setPair( size_t slot, const Pair& pair )
+	{
+		// Store the Pair and keep the index lookup in sync.
+		m_pairs[ slot ] = pair;
+		m_slotsByIndex[ pair.index ] = (int) slot;
+	}
+
+
+	template< typename key_t >
+	void IndexedMinHeap< key_t >::bubbleUp( size_t slot )
+	{
+		Pair pair = m_pairs[ slot ];
+
+		// Move the node as far up the tree as possible.
+		while( slot > 0 )
+		{
+			size_t parentSlot = getParentSlot( slot );
+
+			if( m_pairs[ parentSlot ] > pair )
+			{
+				// If the current node is less than its parent, move the parent down.
+				setPair( slot, m_pairs[ parentSlot ] );
+
+				// Continue re-balancing from the parent slot.
+				slot = parentSlot;
+			}
+			else break;
+		}
+
+		setPair( slot, pair );
+	}
+
+
+	template< typename key_t >
+	void IndexedMinHeap< key_t >::bubbleDown( size_t slot )
+	{
+		Pair pair = m_pairs[ slot ];
+		size_t size = m_pairs.size();
+
+		// Move the node as far down the tree as necessary.
+		while( true )
+		{
+			size_t firstChildSlot = getFirstChildSlot( slot );
+			size_t secondChildSlot = getSecondChildSlot( slot );
+
+			if( firstChildSlot >= size )
+			{
+				// If this node is a leaf, stop bubbling.
+				break;
+			}
+
+			// Check the smaller of the two children.
+			size_t slotToCheck = firstChildSlot;
+
+			if( secondChildSlot < size && ( m_pairs[ firstChildSlot ] > m_pairs[ secondChildSlot ] ) )
+			{
+				slotToCheck = secondChildSlot;
+			}
+
+			if( pair > m_pairs[ slotToCheck ] )
+			{
+				// If the chosen child node is less than the node, move the child up.
+				setPair( slot, m_pairs[ slotToCheck ] );
+
+				// Continue re-balancing from the child slot.
+				slot = slotToCheck;
+			}
+			else break;
+		}
+
+		setPair( slot, pair );
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+namespace mage
+{
+#define MAGE_IMPLEMENT_GET_JSON_VALUE( type, rapidjsonType ) \
+	inline type GetJSON ## rapidjsonType ## Value( const rapidjson::Value& object, const char* name, type const & defaultValue ) \
+	{ \
+		type result = defaultValue; \
+		\
+		if( object.HasMember( name ) ) \
+		{ \
+			const rapidjson::Value& member = object[ name ]; \
+			\
+			if( member.Is ## rapidjsonType () ) \
+			{ \
+				result = member.Get ## rapidjsonType (); \
+			} \
+		} \
+		\
+		return result; \
+	}
+
+
+	MAGE_IMPLEMENT_GET_JSON_VALUE( bool, Bool );
+	MAGE_IMPLEMENT_GET_JSON_VALUE( double, Double );
+	MAGE_IMPLEMENT_GET_JSON_VALUE( int, Int );
+	MAGE_IMPLEMENT_GET_JSON_VALUE( int64_t, Int64 );
+	MAGE_IMPLEMENT_GET_JSON_VALUE( unsigned int, Uint );
+	MAGE_IMPLEMENT_GET_JSON_VALUE( uint64_t, Uint64 );
+	MAGE_IMPLEMENT_GET_JSON_VALUE( const char*, String );
+
+
+	inline std::string ConvertJSONToString( const rapidjson::Value& object )
+	{
+		// Create a buffer and a JSON writer.
+		rapidjson::GenericStringBuffer< rapidjson::UTF8<> > buffer;
+		rapidjson::Writer< rapidjson::GenericStringBuffer< rapidjson::UTF8<> > > writer( buffer );
+
+		// Write the JSON object to the buffer.
+		object.Accept( writer );
+
+		// Return the result;
+		return std::string( buffer.GetString(), buffer.Size() );
+	}
+}
@@ -0,0 +1,85 @@
+#include "androidwars_sim.h"
+
+using namespace mage;
+
+
+const size_t Log::MESSAGE_COUNT;
+const size_t Log::MAX_MESSAGE_LENGTH;
+
+volatile int Log::sLevel = LOG_LEVEL_INFO;
+volatile int Log::sConsoleLevel = LOG_LEVEL_INFO;
+volatile unsigned int Log::sNextSequence = 0;
+Log::Message Log::sMessages[ Log::MESSAGE_COUNT ];
+
+
+void Log::Printf( int level, const char* format, ... )
+{
+	// Format the message into a local buffer (once the slot is published, another writer may reuse it at any time).
+	char text[ MAX_MESSAGE_LENGTH ];
+	va_list arguments;
+	va_start( arguments, format );
+	vsnprintf( text, MAX_MESSAGE_LENGTH, format, arguments );
+	va_end( arguments );
+
+	// Claim the next slot in the ring buffer (overwriting the oldest message).
+	unsigned int sequence = __sync_fetch_and_add( &sNextSequence, 1 );
+	Message& message = sMessages[ sequence % MESSAGE_COUNT ];
+
+	// Mark the slot as being written so readers skip it.
+	message.sequence = 0;
+	__sync_synchronize();
+
+	// Copy the message into the slot.
+	strcpy( message.text, text );
+	message.level = level;
+
+	// Publish the message.
+	__sync_synchronize();
+	message.sequence = ( sequence + 1 );
+
+	if( level >= sConsoleLevel )
+	{
+		// If the message is important enough, print it to the console as well.
+		uint16 style = ( level >= LOG_LEVEL_ERROR ? CONSOLE_ERROR : ( level >= LOG_LEVEL_WARNING ? CONSOLE_WARNING : CONSOLE_INFO ) );
+		ConsolePrintf( style, "%s", text );
+	}
+}
+
+
+void Log::GetRecentMessages( Messages& result )
+{
+	result.clear();
+
+	// Determine the range of messages that may still be in the ring buffer.
+	unsigned int endSequence = sNextSequence;
+	unsigned int beginSequence = ( endSequence > MESSAGE_COUNT ? endSequence - (unsigned int) MESSAGE_COUNT : 0 );
+
+	for( unsigned int sequence = beginSequence; sequence < endSequence; ++sequence )
+	{
+		const Message& message = sMessages[ sequence % MESSAGE_COUNT ];
+
+		if( message.sequence != sequence + 1 )
+		{
+			// If the message is still being written (or was already overwritten), skip it.
+			continue;
+		}
+
+		// Copy the message, then make sure it wasn't overwritten while it was being copied.
+		__sync_synchronize();
+		Message copy = message;
+		__sync_synchronize();
+
+		if( message.sequence == sequence + 1 )
+		{
+			copy.sequence = sequence;
+			result.push_back( copy );
+		}
+	}
+}
+
+
+const char* Log::GetLevelName( int level )
+{
+	static const char* const LEVEL_NAMES[] = { "Trace", "Debug", "Info", "Warning", "Error" };
+	return ( level >= LOG_LEVEL_TRACE && level < LOG_LEVEL_NONE ? LEVEL_NAMES[ level ] : "None" );
+}
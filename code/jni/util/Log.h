@@ -0,0 +1,129 @@
+#pragma once
+
+//---------------------------------------
+// Log levels
+#define LOG_LEVEL_TRACE   0
+#define LOG_LEVEL_DEBUG   1
+#define LOG_LEVEL_INFO    2
+#define LOG_LEVEL_WARNING 3
+#define LOG_LEVEL_ERROR   4
+#define LOG_LEVEL_NONE    5
+//---------------------------------------
+// Messages below the compile level are removed entirely (their arguments are never compiled, let alone evaluated).
+#ifndef LOG_COMPILE_LEVEL
+#	ifndef MAGE_RELEASE
+#		define LOG_COMPILE_LEVEL LOG_LEVEL_TRACE
+#	else
+#		define LOG_COMPILE_LEVEL LOG_LEVEL_WARNING
+#	endif
+#endif
+//---------------------------------------
+// Messages below the runtime level are skipped before any of their arguments are evaluated.
+#define LogMessage( level, ... ) do { if( mage::Log::IsLevelEnabled( level ) ) { mage::Log::Printf( level, __VA_ARGS__ ); } } while( false )
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_TRACE
+#	define LogTrace( ... ) LogMessage( LOG_LEVEL_TRACE, __VA_ARGS__ )
+#else
+#	define LogTrace( ... )
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_DEBUG
+#	define LogDebug( ... ) LogMessage( LOG_LEVEL_DEBUG, __VA_ARGS__ )
+#else
+#	define LogDebug( ... )
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_INFO
+#	define LogInfo( ... ) LogMessage( LOG_LEVEL_INFO, __VA_ARGS__ )
+#else
+#	define LogInfo( ... )
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_WARNING
+#	define LogWarning( ... ) LogMessage( LOG_LEVEL_WARNING, __VA_ARGS__ )
+#else
+#	define LogWarning( ... )
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_ERROR
+#	define LogError( ... ) LogMessage( LOG_LEVEL_ERROR, __VA_ARGS__ )
+#else
+#	define LogError( ... )
+#endif
+
+namespace mage
+{
+	/**
+	 * Leveled logging that keeps the most recent messages in a fixed-size ring buffer. Writers claim a slot with a
+	 * single atomic increment and never block, so logging is safe from any thread (including search and AI jobs).
+	 * Messages at or above the console level are also printed to the console.
+	 */
+	class Log
+	{
+	public:
+		static const size_t MESSAGE_COUNT = 256;
+		static const size_t MAX_MESSAGE_LENGTH = 192;
+
+		/**
+		 * A single message kept by the Log.
+		 */
+		struct Message
+		{
+			unsigned int sequence;
+			int level;
+			char text[ MAX_MESSAGE_LENGTH ];
+		};
+
+		typedef std::vector< Message > Messages;
+
+		static void SetLevel( int level );
+		static int GetLevel();
+		static bool IsLevelEnabled( int level );
+
+		static void SetConsoleLevel( int level );
+		static int GetConsoleLevel();
+
+		static void Printf( int level, const char* format, ... );
+		static void GetRecentMessages( Messages& result );
+
+		static const char* GetLevelName( int level );
+
+	private:
+		Log();
+
+		static volatile int sLevel;
+		static volatile int sConsoleLevel;
+		static volatile unsigned int sNextSequence;
+		static Message sMessages[ MESSAGE_COUNT ];
+	};
+
+
+	inline void Log::SetLevel( int level )
+	{
+		sLevel = level;
+	}
+
+
+	inline int Log::GetLevel()
+	{
+		return sLevel;
+	}
+
+
+	inline bool Log::IsLevelEnabled( int level )
+	{
+		return ( level >= sLevel );
+	}
+
+
+	inline void Log::SetConsoleLevel( int level )
+	{
+		sConsoleLevel = level;
+	}
+
+
+	inline int Log::GetConsoleLevel()
+	{
+		return sConsoleLevel;
+	}
+}
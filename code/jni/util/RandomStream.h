@@ -0,0 +1,108 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * A small, fast random number generator (PCG32) with explicit state. Each Game owns its own stream so that
+	 * results can be reproduced from a saved state and separate simulations never share random state.
+	 * Streams seeded with the same seed but different stream indices produce independent sequences.
+	 */
+	class RandomStream
+	{
+	public:
+		static const uint64 DEFAULT_SEED = 0x853c49e6748fea9bULL;
+		static const uint64 DEFAULT_STREAM_INDEX = 0xda3e39cb94b95bdbULL;
+
+		RandomStream();
+		RandomStream( uint64 seed, uint64 streamIndex = DEFAULT_STREAM_INDEX );
+
+		void Seed( uint64 seed, uint64 streamIndex = DEFAULT_STREAM_INDEX );
+		uint32 Next();
+		int RandomInRange( int minValue, int maxValue );
+
+		void SetState( uint64 state, uint64 increment );
+		uint64 GetState() const;
+		uint64 GetIncrement() const;
+
+	private:
+		uint64 mState;
+		uint64 mIncrement;
+	};
+
+
+	inline RandomStream::RandomStream()
+	{
+		Seed( DEFAULT_SEED );
+	}
+
+
+	inline RandomStream::RandomStream( uint64 seed, uint64 streamIndex )
+	{
+		Seed( seed, streamIndex );
+	}
+
+
+	inline void RandomStream::Seed( uint64 seed, uint64 streamIndex )
+	{
+		// The increment must be odd.
+		mState = 0;
+		mIncrement = ( ( streamIndex << 1 ) | 1 );
+
+		// Mix the seed into the state.
+		Next();
+		mState += seed;
+		Next();
+	}
+
+
+	inline uint32 RandomStream::Next()
+	{
+		uint64 oldState = mState;
+
+		// Advance the internal state.
+		mState = ( oldState * 6364136223846793005ULL + mIncrement );
+
+		// Permute the old state to produce the output.
+		uint32 xorShifted = (uint32) ( ( ( oldState >> 18 ) ^ oldState ) >> 27 );
+		uint32 rotation = (uint32) ( oldState >> 59 );
+		return ( ( xorShifted >> rotation ) | ( xorShifted << ( ( -rotation ) & 31 ) ) );
+	}
+
+
+	inline int RandomStream::RandomInRange( int minValue, int maxValue )
+	{
+		assertion( minValue <= maxValue, "Cannot generate random value in invalid range [%d,%d]!", minValue, maxValue );
+
+		// Reject values from the incomplete last block so every value in the range is equally likely.
+		uint32 bound = (uint32) ( maxValue - minValue ) + 1;
+		uint32 threshold = ( ( -bound ) % bound );
+		uint32 value;
+
+		do
+		{
+			value = Next();
+		}
+		while( value < threshold );
+
+		return ( minValue + (int) ( value % bound ) );
+	}
+
+
+	inline void RandomStream::SetState( uint64 state, uint64 increment )
+	{
+		mState = state;
+		mIncrement = ( increment | 1 );
+	}
+
+
+	inline uint64 RandomStream::GetState() const
+	{
+		return mState;
+	}
+
+
+	inline uint64 RandomStream::GetIncrement() const
+	{
+		return mIncrement;
+	}
+}
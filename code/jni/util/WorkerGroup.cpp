@@ -0,0 +1,73 @@
+#include "androidwars_sim.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+using namespace mage;
+
+
+namespace
+{
+	/**
+	 * The data passed to each worker thread.
+	 */
+	struct WorkerInfo
+	{
+		const WorkerGroup::WorkerFunction* function;
+		int workerIndex;
+	};
+
+
+	void* RunWorkerThread( void* worker )
+	{
+		WorkerInfo* workerInfo = (WorkerInfo*) worker;
+		workerInfo->function->Invoke( workerInfo->workerIndex );
+		return nullptr;
+	}
+}
+
+
+int WorkerGroup::GetDefaultWorkerCount( int maxWorkerCount )
+{
+	// Use one worker for each core (up to the maximum).
+	long coreCount = sysconf( _SC_NPROCESSORS_ONLN );
+	return Mathi::Clamp( (int) std::min( coreCount, (long) maxWorkerCount ), 1, std::max( maxWorkerCount, 1 ) );
+}
+
+
+void WorkerGroup::Run( int workerCount, WorkerFunction function )
+{
+	assertion( function.IsValid(), "Cannot run invalid function on worker threads!" );
+
+	// Start the extra workers (this thread acts as the first worker).
+	workerCount = std::max( workerCount, 1 );
+	std::vector< WorkerInfo > workerInfos( workerCount );
+	std::vector< pthread_t > threads;
+	threads.reserve( workerCount );
+
+	for( int i = 1; i < workerCount; ++i )
+	{
+		workerInfos[ i ].function = &function;
+		workerInfos[ i ].workerIndex = i;
+
+		pthread_t thread;
+
+		if( pthread_create( &thread, nullptr, &RunWorkerThread, &workerInfos[ i ] ) == 0 )
+		{
+			threads.push_back( thread );
+		}
+		else
+		{
+			// If the thread can't be started, the remaining workers pick up its share.
+			WarnFail( "Could not start worker thread %d!", i );
+		}
+	}
+
+	function.Invoke( 0 );
+
+	for( auto it = threads.begin(); it != threads.end(); ++it )
+	{
+		// Wait for all workers to finish.
+		pthread_join( *it, nullptr );
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Runs a function on a group of worker threads and waits for all of them to finish.
+	 * The calling thread acts as the first worker. Callers hand out the work themselves (e.g. by claiming items with
+	 * __sync_fetch_and_add), so if a thread can't be started the remaining workers pick up its share.
+	 */
+	class WorkerGroup
+	{
+	public:
+		typedef FunctionRef< void, int > WorkerFunction;
+
+		static int GetDefaultWorkerCount( int maxWorkerCount );
+		static void Run( int workerCount, WorkerFunction function );
+
+	private:
+		WorkerGroup();
+	};
+}